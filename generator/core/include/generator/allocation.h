@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace generator::allocation {
+
+#ifdef GENERATOR_COUNT_ALLOCATIONS
+  constexpr bool counting = true;
+#else
+  constexpr bool counting = false;
+#endif
+
+  enum class phase { other, load, read, scan, emit };
+
+  constexpr std::size_t phase_count = 5;
+
+  auto name_of(phase phase) noexcept -> std::string_view;
+
+  struct counters {
+    std::uint64_t allocations{ 0 };
+    std::uint64_t bytes{ 0 };
+  };
+
+  // allocations of the calling thread are attributed to this phase
+  auto current_phase() noexcept -> phase&;
+
+  // all zero unless the global allocator is replaced by GENERATOR_COUNT_ALLOCATIONS
+  auto counters_of(phase phase) noexcept -> counters;
+
+  auto peak_rss() noexcept -> std::uint64_t;
+
+  auto to_json() -> std::string;
+
+  // attributes the allocations of the calling thread to a phase until the end of the scope
+  class scope {
+  public:
+    explicit scope(phase phase) noexcept {
+      if constexpr (counting) {
+        previous_ = current_phase();
+        current_phase() = phase;
+      }
+    }
+
+    scope(scope const&) = delete;
+    scope& operator=(scope const&) = delete;
+
+    ~scope() {
+      if constexpr (counting)
+        current_phase() = previous_;
+    }
+
+  private:
+    phase previous_{ phase::other };
+  };
+} // namespace generator::allocation
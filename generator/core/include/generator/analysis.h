@@ -0,0 +1,30 @@
+#pragma once
+#include "generator/feedback.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace generator::analysis {
+  struct rule_cost {
+    std::string           id;
+    regex::cost           matched_text;
+    std::optional<double> throughput; // MB/s over the reference corpus
+  };
+
+  using rule_costs = std::vector<rule_cost>;
+
+  struct thresholds {
+    std::int64_t          memory_budget{ 8 << 20 };
+    std::optional<int>    max_program_size;
+    std::optional<double> min_throughput;
+  };
+
+  auto analyze(feedback::rules const& rules, std::vector<std::string> const& corpus, std::int64_t memory_budget)
+  -> rule_costs;
+  auto violations(rule_costs const& costs, thresholds const& limits) -> std::vector<std::string>;
+
+  void print(std::ostream& out, rule_costs const& costs);
+} // namespace generator::analysis
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace generator::baseline {
+
+  // identifies a finding independent of its line number, so it survives unrelated edits of its file
+  struct fingerprint {
+    std::string   rule;
+    std::string   file;
+    std::uint64_t content{ 0 };
+
+    friend auto operator<(fingerprint const& lhs, fingerprint const& rhs) noexcept {
+      return std::tie(lhs.rule, lhs.file, lhs.content) < std::tie(rhs.rule, rhs.file, rhs.content);
+    }
+  };
+
+  // hashes the matched lines with leading, trailing and repeated whitespace ignored
+  auto content_hash(std::string_view lines) noexcept -> std::uint64_t;
+
+  // a thread safe multiset of fingerprints, stored as one sorted "rule<TAB>file<TAB>hash" line per finding
+  class fingerprints {
+  public:
+    fingerprints() = default;
+    explicit fingerprints(std::string_view content);
+
+    auto to_string() const -> std::string;
+
+    void add(fingerprint const& finding);
+
+    // removes one occurrence, returns false if the finding is new
+    auto consume(fingerprint const& finding) -> bool;
+
+  private:
+    mutable std::mutex                 mutex_;
+    std::map<fingerprint, std::size_t> counts_;
+  };
+} // namespace generator::baseline
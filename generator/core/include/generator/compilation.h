@@ -0,0 +1,43 @@
+#pragma once
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace generator::compilation {
+
+  // an entry of a compilation database, i.e. a compile_commands.json; its paths are absolute
+  struct command {
+    std::filesystem::path    directory;
+    std::filesystem::path    file;
+    std::filesystem::path    output; // empty if unknown
+    std::vector<std::string> arguments;
+  };
+
+  // reads the "arguments" of an entry or splits its "command" like a shell
+  auto parse_commands(std::string_view json) -> std::vector<command>;
+
+  // the dependency file written by the compiler with -MF, or next to its output with -MD/-MMD
+  auto depfile_of(command const& compiled) -> std::optional<std::filesystem::path>;
+
+  // the prerequisites of all rules of a Makefile fragment written by a compiler, i.e. the source and its headers
+  auto parse_depfile(std::string_view content) -> std::vector<std::filesystem::path>;
+
+  // a Makefile fragment making the target depend on the prerequisites, e.g. for the DEPFILE of a custom command
+  auto to_depfile(std::filesystem::path const& target, std::vector<std::filesystem::path> const& prerequisites)
+  -> std::string;
+
+  struct selection {
+    std::string           target;          // only commands whose output lies in CMake's "<target>.dir", if any
+    bool                  headers{ false }; // adds the headers found in the depfiles of the previous build
+    std::filesystem::path root;            // files outside are skipped, e.g. system headers
+    std::filesystem::path build_directory; // files inside are skipped, e.g. generated ones, unless it is the root
+  };
+
+  // the sources of the selected commands and then their headers, each once and in the order of the database
+  auto sources(std::vector<command> const& commands, selection const& selected) -> std::vector<std::filesystem::path>;
+
+  // the depfiles of the selected commands, whether the compiler wrote them already or not
+  auto depfiles(std::vector<command> const& commands, selection const& selected) -> std::vector<std::filesystem::path>;
+} // namespace generator::compilation
@@ -1,8 +1,13 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <optional>
 
 namespace generator::container {
 
@@ -47,15 +52,114 @@ namespace generator::container {
 
     bool is_canonical() const noexcept {
       auto const position =
-      std::adjacent_find(begin(m_map), end(m_map), [](auto&& lhs, auto&& rhs) { return lhs.second == rhs.second; });
-      return position == end(m_map);
+      std::adjacent_find(m_map.begin(), m_map.end(), [](auto&& lhs, auto&& rhs) { return lhs.second == rhs.second; });
+      return position == m_map.end();
     }
 
     V const& operator[](K const& key) const noexcept {
       return (--m_map.upper_bound(key))->second;
     }
 
+    auto begin() const noexcept {
+      return m_map.cbegin();
+    }
+
+    auto end() const noexcept {
+      return m_map.cend();
+    }
+
   private:
     std::map<K, V> m_map;
   };
+
+  // how full a bounded queue was over its lifetime, which shows the stage that limits a pipeline
+  struct occupancy {
+    std::size_t capacity{ 0 };
+    std::size_t peak{ 0 };    // the most items queued at once
+    std::size_t pushed{ 0 };
+    std::size_t blocked{ 0 }; // pushes which waited for a free slot, since the consumers were slower
+    std::size_t starved{ 0 }; // pops which waited for an item, since the producers were slower
+
+    void merge(occupancy const& other) noexcept {
+      capacity = std::max(capacity, other.capacity);
+      peak     = std::max(peak, other.peak);
+      pushed += other.pushed;
+      blocked += other.blocked;
+      starved += other.starved;
+    }
+  };
+
+  // a queue whose producers wait while it is full and whose consumers wait while it is empty, until it is closed
+  template <typename T> class bounded_queue {
+  public:
+    explicit bounded_queue(std::size_t capacity) : capacity_(std::max(capacity, std::size_t{ 1 })) {
+      counters_.capacity = capacity_;
+    }
+
+    // false if the queue is closed, the item is dropped then
+    auto push(T item) -> bool {
+      auto locked = std::unique_lock{ mutex_ };
+
+      if (not closed_ and items_.size() >= capacity_) {
+        ++counters_.blocked;
+        not_full_.wait(locked, [this] { return closed_ or items_.size() < capacity_; });
+      }
+
+      if (closed_)
+        return false;
+
+      items_.push_back(std::move(item));
+      ++counters_.pushed;
+      counters_.peak = std::max(counters_.peak, items_.size());
+
+      locked.unlock();
+      not_empty_.notify_one();
+      return true;
+    }
+
+    // the next item, or nothing once the queue is closed and all of its items are taken
+    auto pop() -> std::optional<T> {
+      auto locked = std::unique_lock{ mutex_ };
+
+      if (not closed_ and items_.empty()) {
+        ++counters_.starved;
+        not_empty_.wait(locked, [this] { return closed_ or not items_.empty(); });
+      }
+
+      if (items_.empty())
+        return std::nullopt;
+
+      auto item = std::optional<T>{ std::move(items_.front()) };
+      items_.pop_front();
+
+      locked.unlock();
+      not_full_.notify_one();
+      return item;
+    }
+
+    // the producers stop, the consumers take the remaining items
+    void close() {
+      {
+        auto const locked = std::lock_guard{ mutex_ };
+        closed_           = true;
+      }
+
+      not_full_.notify_all();
+      not_empty_.notify_all();
+    }
+
+    auto counters() const -> occupancy {
+      auto const locked = std::lock_guard{ mutex_ };
+      return counters_;
+    }
+
+  private:
+    std::size_t const       capacity_;
+    mutable std::mutex      mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T>           items_;
+    occupancy               counters_;
+    bool                    closed_{ false };
+  };
 } // namespace generator::container
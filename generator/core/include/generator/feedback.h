@@ -1,4 +1,5 @@
 #pragma once
+#include "generator/lexer.h"
 #include "generator/regex.h"
 
 #include <string>
@@ -32,6 +33,15 @@ namespace generator::feedback {
 
   using handlings = std::unordered_map<std::string, handling>;
 
+  // whether a rule gets feedback in a source, depending on whether the source changed, and in all of its lines; a
+  // baseline replaces the changes, so any check but nothing applies to whole sources then
+  struct relevance {
+    bool source{ false };
+    bool all_lines{ false };
+  };
+
+  auto relevance_of(handling const& handling, bool changed, bool baseline = false) -> relevance;
+
   class workflow {
   public:
     explicit workflow(feedback::handlings handlings = {}) noexcept;
@@ -52,6 +62,14 @@ namespace generator::feedback {
     regex::precompiled matched_text;
     regex::precompiled ignored_text;
     regex::precompiled marked_text;
+    lexer::regions     scope{ lexer::any };
+
+    // bounds of a match for sources scanned in windows: the lines it may span or, if not 0, its length in bytes
+    int                max_match_lines{ 1 };
+    std::size_t        max_match_length{ 0 };
+
+    // findings of this rule in a source, 0 uses the --max-findings-per-rule of the run
+    std::size_t        max_findings_per_file{ 0 };
   };
 
   using rules = std::unordered_map<std::string, rule>;
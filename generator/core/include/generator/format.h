@@ -10,9 +10,16 @@ namespace generator::format {
     fmt::format_to(std::ostream_iterator<char>(out), fmt, std::forward<Args>(args)...);
   }
 
+  template <class... Args> void print(fmt::memory_buffer& out, std::string_view fmt, Args&&... args) {
+    fmt::format_to(std::back_inserter(out), fmt, std::forward<Args>(args)...);
+  }
+
   struct as_compiler_message {
     std::string_view str;
   };
+
+  // returns the first of '\n', '\r', '\\' or '"' in [first, last) or last, scanning blocks of 16 characters at once
+  auto find_escaped(char const* first, char const* last) noexcept -> char const*;
 } // namespace generator::format
 
 namespace fmt {
@@ -24,46 +31,47 @@ namespace fmt {
 
     template <typename FormatContext>
     auto format(generator::format::as_compiler_message const& text, FormatContext& ctx) {
+      using namespace std::string_view_literals;
+
       auto out = ctx.out();
 
+      auto       first = text.str.data();
+      auto const last  = first + text.str.size();
+
       bool indent{ false };
 
-      for (auto const& ch : text.str) {
+      while (first != last) {
         if (indent) {
-          out    = base.format(' ', ctx);
-          out    = base.format(' ', ctx);
-          out    = base.format(' ', ctx);
-          out    = base.format(' ', ctx);
-          out    = base.format(' ', ctx);
-          out    = base.format(' ', ctx);
-          out    = base.format('|', ctx);
-          out    = base.format(' ', ctx);
+          out    = base.format("      | "sv, ctx);
           indent = false;
         }
 
-        switch (ch) {
+        auto const escaped = generator::format::find_escaped(first, last);
+        if (escaped != first)
+          out = base.format(std::string_view{ first, static_cast<std::size_t>(escaped - first) }, ctx);
+
+        if (escaped == last)
+          break;
+
+        switch (*escaped) {
         case '\n':
-          out    = base.format('\\', ctx);
-          out    = base.format('n', ctx);
+          out    = base.format("\\n"sv, ctx);
           indent = true;
           break;
         case '\r':
           break;
-        case '\\':
-          [[fallthrough]];
-        case '\"':
-          out = base.format('\\', ctx);
-          [[fallthrough]];
         default:
-          out = base.format(ch, ctx);
+          out = base.format(*escaped == '\\' ? "\\\\"sv : "\\\""sv, ctx);
           break;
         }
+
+        first = escaped + 1;
       }
 
       return out;
     }
 
   private:
-    formatter<char> base;
+    formatter<std::string_view> base;
   };
 } // namespace fmt
@@ -1,7 +1,84 @@
 #pragma once
+#include "generator/container.h"
+#include "generator/text.h"
+
+#include <fmt/format.h>
+
+#include <condition_variable>
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace generator::io {
   auto content(std::filesystem::path const& filename) -> std::string;
+  auto binary_content(std::filesystem::path const& filename) -> std::string;
+  void replace_content(std::filesystem::path const& filename, std::string_view content);
+  auto command_output(std::string const& command) -> std::string;
+
+  // reads a file sequentially in windows of whole lines, each followed by at most as many bytes of overlap, so that
+  // only a window and its overlap are held in memory; lines longer than a window are split
+  class window_reader {
+  public:
+    window_reader(std::filesystem::path const& filename, std::size_t window_size);
+
+    // the next window, which is valid until the following call, or nothing after the end of the file
+    auto next() -> std::optional<text::window>;
+
+  private:
+    std::ifstream  in_;
+    std::size_t    window_size_;
+    std::string    buffer_;
+    std::size_t    text_begin_{ 0 };
+    std::size_t    own_length_{ 0 };
+    std::size_t    offset_{ 0 };
+    std::ptrdiff_t preceding_lines_{ 0 };
+  };
+
+  using chunk = fmt::memory_buffer;
+
+  // hands submitted chunks in order to a single writer thread, which writes std::cout with writev on POSIX and
+  // falls back to the stream otherwise; written chunks are recycled by acquire
+  class chunk_writer {
+  public:
+    // submit waits while as many chunks as the capacity are pending, unless it is 0
+    explicit chunk_writer(std::ostream& out, std::size_t capacity = 0);
+    ~chunk_writer();
+
+    chunk_writer(chunk_writer const&) = delete;
+    chunk_writer& operator=(chunk_writer const&) = delete;
+
+    auto acquire() -> chunk;
+    void submit(chunk&& written);
+
+    // blocks until all submitted chunks are written, rethrows a failed write
+    void flush();
+
+    // how many chunks were pending, a batch being written is not pending any longer
+    auto counters() const -> container::occupancy;
+
+  private:
+    void run();
+    void write(std::vector<chunk> const& batch);
+
+    std::ostream&           out_;
+    int                     fd_{ -1 };
+    std::size_t const       capacity_;
+    container::occupancy    counters_;
+    mutable std::mutex      mutex_;
+    std::condition_variable submitted_;
+    std::condition_variable written_;
+    std::vector<chunk>      pending_;
+    std::vector<chunk>      spare_;
+    std::exception_ptr      error_;
+    bool                    writing_{ false };
+    bool                    stopping_{ false };
+    std::thread             thread_;
+  };
 } // namespace generator::io
@@ -4,6 +4,6 @@
 #include <string_view>
 
 namespace generator::json {
-  auto parse_rules(std::string_view json) -> feedback::rules;
+  auto parse_rules(std::string_view json, feedback::workflow const& workflow = feedback::workflow{}) -> feedback::rules;
   auto parse_workflow(std::string_view json) -> feedback::workflow;
 } // namespace generator::json
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace generator::kernel {
+
+  // a hand-written scan for a simple byte-level check, which replaces the regex of a rule with "engine": "builtin:<name>"
+  class builtin {
+  public:
+    // tab, trailing_whitespace, crlf, non_ascii or long_line:<max bytes per line>
+    explicit builtin(std::string_view name);
+
+    // the first match in the input, which is a part of the context, like the first capture of a regex; lines are
+    // measured in bytes from their start in the context, a line ending at the end of the context is complete
+    auto find(std::string_view input, std::string_view context) const noexcept -> std::optional<std::string_view>;
+
+  private:
+    enum class check { tab, trailing_whitespace, crlf, non_ascii, long_line };
+
+    check       check_;
+    std::size_t max_line_length_{ 0 };
+  };
+} // namespace generator::kernel
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace generator::lexer {
+
+  using regions = std::uint8_t;
+
+  constexpr regions code         = 1;
+  constexpr regions comment      = 2;
+  constexpr regions string       = 4;
+  constexpr regions preprocessor = 8;
+  constexpr regions any          = code | comment | string | preprocessor;
+
+  // code, comment, string, preprocessor or any
+  auto to_regions(std::string_view name) -> regions;
+
+  // the lexical region of each character of a C/C++ source, found in a single pass and stored as runs
+  class mask {
+  public:
+    explicit mask(std::string_view source);
+
+    auto operator[](std::size_t offset) const noexcept -> regions;
+
+  private:
+    void mark(std::size_t offset, regions region);
+
+    std::vector<std::size_t> starts_;
+    std::vector<regions>     regions_;
+  };
+} // namespace generator::lexer
@@ -1,10 +1,17 @@
 #pragma once
+#include "generator/baseline.h"
+#include "generator/container.h"
 #include "generator/feedback.h"
+#include "generator/profile.h"
 #include "generator/scm.h"
+#include "generator/trace.h"
 
+#include <chrono>
 #include <filesystem>
 #include <future>
 #include <iosfwd>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace generator::output {
@@ -16,20 +23,79 @@ namespace generator::output {
     std::shared_future<scm::diff> const&                          shared_diff;
   };
 
+  struct options {
+    profile::recorder* profiler{ nullptr };
+    trace::recorder*   tracer{ nullptr };
+    std::size_t        max_findings{ 0 }; // no limit if 0
+    std::size_t        max_errors{ 0 };   // no limit if 0
+
+    // findings of a rule and of all rules in a source, a note at the first suppressed one counts all of them
+    std::size_t max_findings_per_rule{ 0 }; // no limit if 0, overridden by the max_findings_per_file of a rule
+    std::size_t max_findings_per_file{ 0 }; // no limit if 0
+
+    // findings in the known baseline are not reported, all findings are added to the recorded one
+    baseline::fingerprints* known_findings{ nullptr };
+    baseline::fingerprints* recorded_findings{ nullptr };
+
+    // sources larger than this are read and scanned in windows of about this size, 0 reads every source as a whole;
+    // rules with a scope are rejected then, since a window may start inside a comment or a raw string
+    std::size_t window_size{ 0 };
+
+    // sources read as a whole and larger than this are split into segments of about this size, which each rule scans
+    // in parallel, 0 scans every source as a whole
+    std::size_t segment_size{ 0 };
+
+    // changed sources are scanned first and the remaining ones by size, no source is started after the deadline
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+
+    // a reader reads the sources ahead of the scanners, which hand the generated sections to a writer; the queues in
+    // between bound the memory of sources and sections in flight, 0 chooses twice the scanners
+    std::size_t scanners{ 0 }; // the hardware threads if 0
+    std::size_t read_ahead{ 0 };
+    std::size_t pending_sections{ 0 };
+  };
+
   struct stats {
     void process(std::string_view source) {
+      process(source.length());
+    }
+
+    void process(std::size_t length) {
       ++sources;
-      bytes += source.length();
+      bytes += length;
     }
 
     void merge(stats const& other) {
       sources += other.sources;
       bytes += other.bytes;
+      unscanned.insert(end(unscanned), cbegin(other.unscanned), cend(other.unscanned));
+      if (suppressed_after.empty())
+        suppressed_after = other.suppressed_after;
+      if (stopped_after.empty())
+        stopped_after = other.stopped_after;
+      read_queue.merge(other.read_queue);
+      section_queue.merge(other.section_queue);
     }
 
     size_t sources{ 0 };
     size_t bytes{ 0 };
+
+    std::vector<std::filesystem::path> unscanned;
+
+    // the limit which suppressed further findings, e.g. "--max-findings=100", if any
+    std::string suppressed_after;
+
+    // the limit which cancelled the remaining scans before any finding was suppressed, if any
+    std::string stopped_after;
+
+    // sources read but not yet scanned and sections generated but not yet written
+    container::occupancy read_queue;
+    container::occupancy section_queue;
   };
 
-  auto print(std::ostream& out, output::matches matches, stats merged_stats = {}) -> stats;
+  auto print(std::ostream& out, output::matches matches, output::options options = {}, stats merged_stats = {}) -> stats;
+
+  // the notes which end a generated file, about the sources left unscanned, the findings suppressed and the scans
+  // cancelled by a limit
+  auto notes(std::filesystem::path const& rules_origin, output::stats const& stats) -> std::string;
 } // namespace generator::output
@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace generator::profile {
+
+  using clock    = std::chrono::steady_clock;
+  using duration = std::chrono::nanoseconds;
+
+  struct rule_counters {
+    std::size_t files{ 0 };
+    std::size_t bytes{ 0 };
+    std::size_t matches{ 0 };
+    std::size_t ignored_matches{ 0 };
+    duration    time{ 0 };
+  };
+
+  // the wall times of reading and scanning a source, and the times of its rules, which run in parallel, summed up
+  struct file_timings {
+    duration read{ 0 };
+    duration scan{ 0 }; // all rules, finding and emitting their matches
+    duration rule_scan{ 0 };
+    duration rule_emit{ 0 };
+  };
+
+  class recorder {
+  public:
+    explicit recorder(std::size_t top_count = 20);
+
+    void record(std::string const& rule, std::filesystem::path const& source, rule_counters const& counters);
+    void record(std::filesystem::path const& source, file_timings const& timings);
+
+    auto to_json() const -> std::string;
+
+  private:
+    struct rule_in_source {
+      duration              time;
+      std::string           rule;
+      std::filesystem::path source;
+    };
+
+    struct hash {
+      std::size_t operator()(std::filesystem::path const& source) const noexcept {
+        return hash_value(source);
+      }
+    };
+
+    mutable std::mutex                                            mutex_;
+    std::size_t                                                   top_count_;
+    std::unordered_map<std::string, rule_counters>                rules_;
+    std::unordered_map<std::filesystem::path, file_timings, hash> files_;
+    std::vector<rule_in_source>                                   slowest_;
+  };
+} // namespace generator::profile
@@ -1,12 +1,24 @@
 #pragma once
+#include <cstdint>
 #include <initializer_list>
 #include <memory>
 #include <string_view>
 
+namespace generator::kernel {
+  class builtin;
+} // namespace generator::kernel
+
 namespace generator::regex {
 
   using match = std::string_view;
 
+  struct cost {
+    int  program_size{ 0 };
+    bool required_literal{ false };
+    bool anchored{ false };
+    bool within_budget{ false };
+  };
+
   class precompiled {
   public:
     precompiled() = default;
@@ -16,15 +28,29 @@ namespace generator::regex {
 
     auto find(std::string_view input, match* match_ret, match* skipped_ret, match* remaining_ret) const -> bool;
 
+    // like find, but ^, $ and \b see the surrounding context, of which the input is a part
+    auto find(std::string_view input, std::string_view context, match* match_ret, match* skipped_ret,
+              match* remaining_ret) const -> bool;
+
+    auto cost(std::int64_t memory_budget) const -> regex::cost;
+
   private:
     explicit precompiled(std::string_view pattern);
     friend auto compile(std::string_view pattern) -> precompiled;
+    friend auto builtin(std::string_view name) -> precompiled;
+
+    auto find_builtin(std::string_view input, std::string_view context, match* match_ret, match* skipped_ret,
+                      match* remaining_ret) const -> bool;
 
   private:
     class impl;
-    std::shared_ptr<impl> engine;
+    std::shared_ptr<impl>                  engine;
+    std::shared_ptr<kernel::builtin const> kernel;
   };
 
   auto compile(std::string_view pattern) -> precompiled;
   auto capture(std::string_view pattern) -> precompiled;
+
+  // a hand-written kernel which finds its matches like the first capture of a regex, see kernel::builtin
+  auto builtin(std::string_view name) -> precompiled;
 } // namespace generator::regex
@@ -0,0 +1,37 @@
+#pragma once
+#include "generator/feedback.h"
+#include "generator/scm.h"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace generator::scan {
+
+  // a source held in memory, e.g. the unsaved content of an editor; its path selects the rules which apply to it
+  struct buffer {
+    std::filesystem::path             path;
+    std::string_view                  content;
+    std::optional<scm::diff::changes> changes; // all lines are changed if there are none
+  };
+
+  // a finding owns its text, so it outlives the buffer it was found in
+  struct finding {
+    std::string           rule;
+    feedback::response    response;
+    std::filesystem::path source;
+    int                   line{ 0 };
+    int                   column{ 0 };
+    std::string           matched_text;
+    std::string           matched_lines;
+  };
+
+  // the findings of compiled rules in buffers, sorted by source, line, column and rule, without reading or writing any
+  // file; concurrent calls are safe as long as none of their arguments is modified
+  auto find(feedback::rules const& rules, feedback::workflow const& workflow, std::vector<buffer> const& buffers)
+  -> std::vector<finding>;
+
+  auto find(feedback::rules const& rules, feedback::workflow const& workflow, buffer const& source) -> std::vector<finding>;
+} // namespace generator::scan
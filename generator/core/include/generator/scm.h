@@ -1,9 +1,13 @@
 #pragma once
 #include "generator/container.h"
 
+#include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace generator::scm {
   class diff {
@@ -26,11 +30,27 @@ namespace generator::scm {
         return parse_from(block, {});
       }
 
+      static auto all_lines() -> changes;
+
+      // the lines from first to last, both included and counted from 1, in addition to the merged changes
+      static auto lines(int first, int last, changes merged) -> changes;
+      static auto lines(int first, int last) -> changes {
+        return lines(first, last, {});
+      }
+
     private:
+      friend class diff;
+
       container::interval_map<int, bool> modified{ false };
     };
 
     static auto parse(std::string_view output, diff merged = {}) -> diff;
+    static auto parse_untracked(std::string_view file_list, diff merged = {}) -> diff;
+    static auto from_git(std::string_view relevant_changes, std::vector<std::filesystem::path> const& sources,
+                         diff merged = {}) -> diff;
+    static auto parse_indexed(std::filesystem::path const& filename, std::filesystem::path const& index_filename) -> diff;
+    static auto from_index(std::string_view index, std::uint64_t stamp) -> std::optional<diff>;
+    auto        to_index(std::uint64_t stamp) const -> std::string;
     auto        changes_from(std::filesystem::path const& source) const -> changes;
 
   private:
@@ -0,0 +1,51 @@
+#pragma once
+#include "generator/output.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace generator::shard {
+
+  enum class partitioning { hash, size };
+
+  // hash or size
+  auto to_partitioning(std::string_view name) -> partitioning;
+
+  // the index-th of count shards, counted from 1
+  struct selection {
+    std::size_t  index{ 1 };
+    std::size_t  count{ 1 };
+    partitioning by{ partitioning::hash };
+  };
+
+  // parses "index/count"
+  auto parse(std::string_view text, partitioning by = partitioning::hash) -> selection;
+
+  // the sources of a shard in their original order; every machine with the same checkout selects the same ones, by the
+  // hash of their path or by bins of about the same total size
+  auto select(std::vector<std::filesystem::path> const& sources, selection shard) -> std::vector<std::filesystem::path>;
+
+  // the stats of a run as JSON, so that the stats of all shards can be merged
+  auto to_json(output::stats const& stats) -> std::string;
+  auto parse_stats(std::string_view json) -> output::stats;
+
+  // the header and the sections of a generated file, each of which starts with the #line directive of its source
+  struct generated_file {
+    std::string_view              header;
+    std::vector<std::string_view> sections;
+  };
+
+  auto parse_generated(std::string_view generated) -> generated_file;
+
+  // the #line directive which starts a section
+  auto directive_of(std::string_view section) -> std::string_view;
+
+  // the generated files of all shards as one, with a single header and the sections of all sources sorted by source;
+  // the notes of the shards, whose sections start with the directive of the rules, are replaced by those of the merged
+  // stats
+  auto merge(std::vector<std::string> const& generated, std::filesystem::path const& rules_origin,
+             output::stats const& merged_stats) -> std::string;
+} // namespace generator::shard
@@ -1,6 +1,9 @@
 #pragma once
+#include <cstddef>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace generator::regex {
   class precompiled;
@@ -33,18 +36,50 @@ namespace generator::text {
 
   class excerpt {
   public:
-    excerpt(std::string_view text, std::string_view match);
+    // the indentation and the annotation are allocated from the resource, e.g. an arena released after each finding
+    excerpt(std::string_view text, std::string_view match,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
   public:
     std::string_view first_line;
-    std::string      indentation;
-    std::string      annotation;
+    std::pmr::string indentation;
+    std::pmr::string annotation;
   };
 
+  // a line aligned part of a larger text: its own lines followed by an overlap into the next window, within some of
+  // the surrounding text as context
+  struct window {
+    std::string_view context;
+    std::string_view text;
+    std::size_t      own_length{ 0 };
+    std::ptrdiff_t   preceding_lines{ 0 };
+    std::size_t      offset{ 0 };
+
+    static auto whole(std::string_view text) noexcept -> window {
+      return { text, text, text.length(), 0, 0 };
+    }
+  };
+
+  // the length of the whole lines at the beginning of a text which fit into the given size, or the size if the first
+  // line is longer
+  auto window_length(std::string_view text, std::size_t size) noexcept -> std::size_t;
+
+  // splits a text into windows of whole lines of about the given size, each overlapping the next one by at most as much
+  auto split(std::string_view text, std::size_t size) -> std::vector<window>;
+
+  // the excerpt of the matched lines, which marks the highlighted part of the matched text
+  auto highlight(std::string_view matched_lines, std::string_view matched_text, regex::precompiled const& pattern,
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource()) -> excerpt;
+
   class forward_search {
   public:
-    explicit forward_search(std::string_view const& text) noexcept
-    : processed_line_count(0), processed(text.data(), 0), current_match(text.data(), 0), remaining(text) {
+    explicit forward_search(std::string_view const& text) noexcept : forward_search(text, text, 0) {
+    }
+
+    // searches a part of the context, counting lines after the preceding ones
+    forward_search(std::string_view const& text, std::string_view const& context, std::ptrdiff_t preceding_lines) noexcept
+    : processed_line_count(preceding_lines), processed(text.data(), 0), current_match(text.data(), 0), remaining(text),
+      context(context), resumed(text.data() == context.data()) {
     }
 
     auto next(regex::precompiled const& pattern) -> bool;
@@ -58,6 +93,9 @@ namespace generator::text {
 
     auto matched_lines() const -> std::string_view;
 
+    // continues after the first length bytes as if a match ended there
+    void resume_at(std::size_t length);
+
     auto line() const noexcept -> int {
       return static_cast<int>(processed_line_count + 1);
     }
@@ -76,5 +114,7 @@ namespace generator::text {
     std::string_view current_match;
     std::string_view first_remaining_line;
     std::string_view remaining;
+    std::string_view context;
+    bool             resumed;
   };
 } // namespace generator::text
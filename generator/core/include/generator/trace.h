@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace generator::trace {
+
+  using clock = std::chrono::steady_clock;
+
+  // collects complete events in the Chrome/Perfetto trace event format
+  class recorder {
+  public:
+    recorder();
+
+    void record(std::string_view name, std::string_view detail, clock::time_point begin, clock::time_point end);
+
+    auto to_json() const -> std::string;
+
+  private:
+    struct event {
+      std::string       name;
+      std::string       detail;
+      clock::time_point begin;
+      clock::time_point end;
+      std::thread::id   thread;
+    };
+
+    clock::time_point  start_;
+    mutable std::mutex mutex_;
+    std::vector<event> events_;
+  };
+
+  // records the lifetime of a scope, does nothing without a recorder; its detail is copied only with a recorder, a
+  // path is even converted only then
+  class span {
+  public:
+    span(recorder* tracer, std::string_view name, std::string_view detail = {})
+    : tracer_(tracer), name_(name), detail_(tracer ? detail : std::string_view{}),
+      begin_(tracer ? clock::now() : clock::time_point{}) {
+    }
+
+    span(recorder* tracer, std::string_view name, std::string const& detail)
+    : span(tracer, name, std::string_view{ detail }) {
+    }
+
+    span(recorder* tracer, std::string_view name, std::filesystem::path const& detail) : span(tracer, name) {
+      if (tracer)
+        detail_ = detail.generic_u8string();
+    }
+
+    span(span const&) = delete;
+    span& operator=(span const&) = delete;
+
+    ~span() {
+      if (tracer_)
+        tracer_->record(name_, detail_, begin_, clock::now());
+    }
+
+  private:
+    recorder*         tracer_;
+    std::string_view  name_;
+    std::string       detail_;
+    clock::time_point begin_;
+  };
+} // namespace generator::trace
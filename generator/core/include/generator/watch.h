@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace generator::watch {
+
+  // the generated file of a watched run, whose sections are replaced source by source as the sources change
+  class results {
+  public:
+    // the notes about finding limits and time budgets start with the #line directive of the rules
+    explicit results(std::filesystem::path const& rules_origin);
+
+    // replaces the header, the notes and the sections of all sources of a generated file
+    void update(std::string_view generated);
+
+    // drops the section of a source, e.g. after it was deleted
+    void remove(std::filesystem::path const& source);
+
+    void clear();
+
+    // the header and all sections, sorted by source
+    auto to_string() const -> std::string;
+
+  private:
+    std::string                        notes_directive_;
+    std::string                        header_;
+    std::map<std::string, std::string> sections_;
+  };
+
+  // reports changes of files with inotify, which watches their directories so that editors replacing a file by a
+  // renamed one are noticed as well; only available on Linux
+  class watcher {
+  public:
+    explicit watcher(std::vector<std::filesystem::path> const& files);
+    ~watcher();
+
+    watcher(watcher const&) = delete;
+    watcher& operator=(watcher const&) = delete;
+
+    // blocks until a file changes, then collects further changes until none follows within the latency; the changed
+    // files are reported as they were passed in, all of them if the kernel dropped events
+    auto wait(std::chrono::milliseconds latency) -> std::vector<std::filesystem::path>;
+
+  private:
+    int                                                    fd_{ -1 };
+    std::unordered_map<int, std::filesystem::path>         directories_;
+    std::map<std::filesystem::path, std::filesystem::path> files_;
+  };
+} // namespace generator::watch
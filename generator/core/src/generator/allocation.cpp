@@ -0,0 +1,212 @@
+#include "generator/allocation.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace generator::allocation {
+
+  namespace {
+    struct atomic_counters {
+      std::atomic<std::uint64_t> allocations{ 0 };
+      std::atomic<std::uint64_t> bytes{ 0 };
+    };
+
+    // constant initialized, so it is usable by allocations before main
+    atomic_counters phase_counters[phase_count];
+
+    thread_local phase thread_phase{ phase::other };
+  } // namespace
+
+  auto name_of(phase phase) noexcept -> std::string_view {
+    switch (phase) {
+    case phase::load:
+      return "load";
+    case phase::read:
+      return "read";
+    case phase::scan:
+      return "scan";
+    case phase::emit:
+      return "emit";
+    default:
+      return "other";
+    }
+  }
+
+  auto current_phase() noexcept -> phase& {
+    return thread_phase;
+  }
+
+  auto counters_of(phase phase) noexcept -> counters {
+    auto const& counted = phase_counters[static_cast<std::size_t>(phase)];
+    return { counted.allocations.load(std::memory_order_relaxed), counted.bytes.load(std::memory_order_relaxed) };
+  }
+
+  auto peak_rss() noexcept -> std::uint64_t {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memory_counters{};
+    if (not K32GetProcessMemoryInfo(GetCurrentProcess(), &memory_counters, sizeof(memory_counters)))
+      return 0;
+    return memory_counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  }
+
+  auto to_json() -> std::string {
+    auto json = nlohmann::json{ { "counting", counting }, { "peak_rss", peak_rss() } };
+
+    for (std::size_t index = 0; index < phase_count; ++index) {
+      auto const phase    = static_cast<allocation::phase>(index);
+      auto const counters = counters_of(phase);
+
+      json["phases"][std::string{ name_of(phase) }] = { { "allocations", counters.allocations },
+                                                        { "bytes", counters.bytes } };
+    }
+
+    return json.dump(2);
+  }
+} // namespace generator::allocation
+
+#ifdef GENERATOR_COUNT_ALLOCATIONS
+
+namespace {
+  void count(std::size_t size) noexcept {
+    auto& counted = generator::allocation::phase_counters[static_cast<std::size_t>(generator::allocation::thread_phase)];
+
+    counted.allocations.fetch_add(1, std::memory_order_relaxed);
+    counted.bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  auto counted_allocation(std::size_t size) noexcept -> void* {
+    count(size);
+    return std::malloc(size == 0 ? 1 : size);
+  }
+
+  auto counted_allocation(std::size_t size, std::align_val_t alignment) noexcept -> void* {
+    count(size);
+
+    auto const aligned_to = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? 1 : size, aligned_to);
+#else
+    // aligned_alloc requires a multiple of the alignment
+    return std::aligned_alloc(aligned_to, (std::max(size, std::size_t{ 1 }) + aligned_to - 1) / aligned_to * aligned_to);
+#endif
+  }
+
+  void aligned_free(void* memory) noexcept {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+  }
+
+  template <class... ALIGNMENT> auto counted_allocation_or_throw(std::size_t size, ALIGNMENT... alignment) -> void* {
+    if (auto* const memory = counted_allocation(size, alignment...))
+      return memory;
+
+    throw std::bad_alloc{};
+  }
+} // namespace
+
+void* operator new(std::size_t size) {
+  return counted_allocation_or_throw(size);
+}
+
+void* operator new[](std::size_t size) {
+  return counted_allocation_or_throw(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+  return counted_allocation(size);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::nothrow_t const&) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::nothrow_t const&) noexcept {
+  std::free(memory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return counted_allocation_or_throw(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return counted_allocation_or_throw(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+  return counted_allocation(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept {
+  return counted_allocation(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+  aligned_free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+  aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+  aligned_free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, std::nothrow_t const&) noexcept {
+  aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, std::nothrow_t const&) noexcept {
+  aligned_free(memory);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "generator/analysis.h"
+
+#include "generator/format.h"
+#include "generator/text.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+namespace generator::analysis {
+
+  namespace {
+    auto measure_throughput(feedback::rule const& rule, std::vector<std::string> const& corpus) -> std::optional<double> {
+      auto constexpr min_duration = std::chrono::milliseconds{ 20 };
+
+      auto bytes = std::size_t{ 0 };
+      for (auto const& text : corpus)
+        bytes += text.length();
+
+      if (bytes == 0)
+        return std::nullopt;
+
+      auto       passes  = 0;
+      auto const start   = std::chrono::steady_clock::now();
+      auto       elapsed = std::chrono::steady_clock::duration{};
+
+      do {
+        for (auto const& text : corpus) {
+          auto search = text::forward_search{ text };
+          while (search.next_but(rule.matched_text, rule.ignored_text)) {
+          }
+        }
+
+        ++passes;
+        elapsed = std::chrono::steady_clock::now() - start;
+      } while (elapsed < min_duration);
+
+      auto const seconds = std::chrono::duration<double>{ elapsed }.count();
+      return static_cast<double>(bytes) * passes / seconds / 1e6;
+    }
+
+    auto yes_no(bool value) {
+      return value ? "yes" : "no";
+    }
+  } // namespace
+
+  auto analyze(feedback::rules const& rules, std::vector<std::string> const& corpus, std::int64_t memory_budget)
+  -> rule_costs {
+    auto costs = rule_costs{};
+
+    for (auto const& [id, rule] : rules)
+      costs.push_back({ id, rule.matched_text.cost(memory_budget), measure_throughput(rule, corpus) });
+
+    std::sort(begin(costs), end(costs), [](auto const& lhs, auto const& rhs) { return lhs.id < rhs.id; });
+    return costs;
+  }
+
+  auto violations(rule_costs const& costs, thresholds const& limits) -> std::vector<std::string> {
+    auto found = std::vector<std::string>{};
+
+    for (auto const& cost : costs) {
+      if (not cost.matched_text.within_budget)
+        found.push_back(fmt::format("{}: matched_text exceeds the memory budget of {} byte(s)", cost.id, limits.memory_budget));
+
+      if (limits.max_program_size and cost.matched_text.program_size > *limits.max_program_size)
+        found.push_back(fmt::format("{}: program size {} exceeds {}", cost.id, cost.matched_text.program_size,
+                                    *limits.max_program_size));
+
+      if (limits.min_throughput and cost.throughput and *cost.throughput < *limits.min_throughput)
+        found.push_back(fmt::format("{}: throughput {:.1f} MB/s is below {:.1f} MB/s", cost.id, *cost.throughput,
+                                    *limits.min_throughput));
+    }
+
+    return found;
+  }
+
+  void print(std::ostream& out, rule_costs const& costs) {
+    format::print(out, "{:<20} {:>12} {:>8} {:>8} {:>8} {:>12}\n", "rule", "program size", "literal", "anchored",
+                  "budget", "MB/s");
+
+    for (auto const& cost : costs)
+      format::print(out, "{:<20} {:>12} {:>8} {:>8} {:>8} {:>12}\n", cost.id, cost.matched_text.program_size,
+                    yes_no(cost.matched_text.required_literal), yes_no(cost.matched_text.anchored),
+                    cost.matched_text.within_budget ? "ok" : "exceeded",
+                    cost.throughput ? fmt::format("{:.1f}", *cost.throughput) : "n/a");
+  }
+} // namespace generator::analysis
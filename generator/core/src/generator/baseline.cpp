@@ -0,0 +1,102 @@
+#include "generator/baseline.h"
+
+#include "generator/format.h"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace generator::baseline {
+
+  namespace {
+    constexpr auto is_space(char ch) noexcept {
+      return ch == ' ' or ch == '\t' or ch == '\r' or ch == '\n' or ch == '\f' or ch == '\v';
+    }
+
+    constexpr auto fnv1a(std::uint64_t hash, char ch) noexcept {
+      return (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3;
+    }
+
+    auto next_field(std::string_view& line) -> std::string_view {
+      auto const tab   = line.find('\t');
+      auto const field = line.substr(0, tab);
+
+      line = tab == std::string_view::npos ? std::string_view{} : line.substr(tab + 1);
+      return field;
+    }
+  } // namespace
+
+  auto content_hash(std::string_view lines) noexcept -> std::uint64_t {
+    auto hash          = std::uint64_t{ 0xcbf29ce484222325 };
+    auto pending_space = false;
+    auto any_character = false;
+
+    for (auto const ch : lines) {
+      if (is_space(ch)) {
+        pending_space = any_character;
+        continue;
+      }
+
+      if (pending_space)
+        hash = fnv1a(hash, ' ');
+
+      hash          = fnv1a(hash, ch);
+      pending_space = false;
+      any_character = true;
+    }
+
+    return hash;
+  }
+
+  fingerprints::fingerprints(std::string_view content) {
+    while (not content.empty()) {
+      auto const newline = content.find('\n');
+      auto       line    = content.substr(0, newline);
+
+      content = newline == std::string_view::npos ? std::string_view{} : content.substr(newline + 1);
+
+      if (not line.empty() and line.back() == '\r')
+        line.remove_suffix(1);
+      if (line.empty())
+        continue;
+
+      auto finding = fingerprint{};
+      finding.rule = next_field(line);
+      finding.file = next_field(line);
+
+      auto const hash = next_field(line);
+      if (std::from_chars(hash.data(), hash.data() + hash.size(), finding.content, 16).ec != std::errc{})
+        throw std::invalid_argument{ "invalid baseline entry: " + finding.rule };
+
+      ++counts_[std::move(finding)];
+    }
+  }
+
+  auto fingerprints::to_string() const -> std::string {
+    auto const locked = std::lock_guard{ mutex_ };
+    auto       result = std::string{};
+
+    for (auto const& [finding, count] : counts_)
+      for (std::size_t index = 0; index < count; ++index)
+        result += fmt::format("{}\t{}\t{:016x}\n", finding.rule, finding.file, finding.content);
+
+    return result;
+  }
+
+  void fingerprints::add(fingerprint const& finding) {
+    auto const locked = std::lock_guard{ mutex_ };
+    ++counts_[finding];
+  }
+
+  auto fingerprints::consume(fingerprint const& finding) -> bool {
+    auto const locked   = std::lock_guard{ mutex_ };
+    auto const position = counts_.find(finding);
+
+    if (position == counts_.end())
+      return false;
+
+    if (--position->second == 0)
+      counts_.erase(position);
+
+    return true;
+  }
+} // namespace generator::baseline
@@ -0,0 +1,281 @@
+#include "generator/compilation.h"
+
+#include "generator/io.h"
+
+#include <nlohmann/json.hpp>
+
+#include <unordered_set>
+
+namespace generator::compilation {
+
+  namespace {
+    constexpr auto is_space(char ch) noexcept {
+      return ch == ' ' or ch == '\t' or ch == '\r' or ch == '\n';
+    }
+
+    // splits a command line like a POSIX shell, with quotes and backslash escapes
+    auto split(std::string_view command_line) -> std::vector<std::string> {
+      auto arguments = std::vector<std::string>{};
+      auto argument  = std::optional<std::string>{};
+      auto quote     = char{ 0 };
+
+      for (std::size_t index = 0; index < command_line.length(); ++index) {
+        auto const ch = command_line[index];
+
+        if (quote == '\'') {
+          if (ch == quote)
+            quote = 0;
+          else
+            argument->push_back(ch);
+        }
+        else if (quote == '"') {
+          if (ch == quote)
+            quote = 0;
+          else if (ch == '\\' and index + 1 < command_line.length() and
+                   (command_line[index + 1] == '"' or command_line[index + 1] == '\\'))
+            argument->push_back(command_line[++index]);
+          else
+            argument->push_back(ch);
+        }
+        else if (is_space(ch)) {
+          if (argument)
+            arguments.push_back(std::move(*argument));
+          argument.reset();
+        }
+        else {
+          if (not argument)
+            argument.emplace();
+
+          if (ch == '\'' or ch == '"')
+            quote = ch;
+          else if (ch == '\\' and index + 1 < command_line.length())
+            argument->push_back(command_line[++index]);
+          else
+            argument->push_back(ch);
+        }
+      }
+
+      if (argument)
+        arguments.push_back(std::move(*argument));
+
+      return arguments;
+    }
+
+    // the value of an option given as "-o value" or "-ovalue"
+    auto option_value(std::vector<std::string> const& arguments, std::size_t& index, std::string_view option)
+    -> std::optional<std::string> {
+      auto const& argument = arguments[index];
+
+      if (argument.compare(0, option.length(), option) != 0)
+        return std::nullopt;
+
+      if (argument.length() > option.length())
+        return argument.substr(option.length());
+
+      if (index + 1 < arguments.size())
+        return arguments[++index];
+
+      return std::nullopt;
+    }
+
+    auto output_of(std::vector<std::string> const& arguments) -> std::filesystem::path {
+      for (std::size_t index = 0; index < arguments.size(); ++index)
+        for (auto const option : { "-o", "/Fo", "-Fo" })
+          if (auto value = option_value(arguments, index, option))
+            return *value;
+
+      return {};
+    }
+
+    auto within(std::filesystem::path const& file, std::filesystem::path const& directory) {
+      auto const relative = file.lexically_relative(directory);
+      return not relative.empty() and *relative.begin() != "..";
+    }
+
+    auto built_by(command const& compiled, std::string const& target) {
+      auto const directory = target + ".dir";
+
+      for (auto const& element : compiled.output)
+        if (element == directory)
+          return true;
+
+      return false;
+    }
+
+    auto chosen(std::vector<command> const& commands, std::string const& target) {
+      auto found = std::vector<command const*>{};
+      for (auto const& compiled : commands)
+        if (target.empty() or built_by(compiled, target))
+          found.push_back(&compiled);
+
+      return found;
+    }
+  } // namespace
+
+  auto parse_commands(std::string_view json) -> std::vector<command> {
+    auto commands = std::vector<command>{};
+
+    for (auto const& entry : nlohmann::json::parse(json)) {
+      auto compiled      = command{};
+      compiled.directory = std::filesystem::u8path(entry.at("directory").get<std::string>());
+      compiled.file      = (compiled.directory / std::filesystem::u8path(entry.at("file").get<std::string>())).lexically_normal();
+
+      if (entry.contains("arguments"))
+        compiled.arguments = entry.at("arguments").get<std::vector<std::string>>();
+      else
+        compiled.arguments = split(entry.at("command").get<std::string>());
+
+      auto const output = entry.contains("output") ? std::filesystem::u8path(entry.at("output").get<std::string>())
+                                                   : output_of(compiled.arguments);
+      if (not output.empty())
+        compiled.output = (compiled.directory / output).lexically_normal();
+
+      commands.push_back(std::move(compiled));
+    }
+
+    return commands;
+  }
+
+  auto depfile_of(command const& compiled) -> std::optional<std::filesystem::path> {
+    auto dependencies = false;
+
+    for (std::size_t index = 0; index < compiled.arguments.size(); ++index) {
+      auto const& argument = compiled.arguments[index];
+
+      if (argument == "-MD" or argument == "-MMD")
+        dependencies = true;
+      else if (auto value = option_value(compiled.arguments, index, "-MF"))
+        return (compiled.directory / std::filesystem::u8path(*value)).lexically_normal();
+    }
+
+    // like the compiler, which replaces the suffix of the output
+    if (dependencies and not compiled.output.empty())
+      return std::filesystem::path{ compiled.output }.replace_extension(".d");
+
+    return std::nullopt;
+  }
+
+  auto parse_depfile(std::string_view content) -> std::vector<std::filesystem::path> {
+    auto prerequisites = std::vector<std::filesystem::path>{};
+    auto tokens        = std::vector<std::string>{};
+    auto token         = std::string{};
+    auto separated     = false;
+
+    auto const end_token = [&] {
+      if (not token.empty())
+        tokens.push_back(std::move(token));
+      token.clear();
+    };
+
+    auto const end_rule = [&] {
+      end_token();
+      if (separated)
+        for (auto const& prerequisite : tokens)
+          prerequisites.push_back(std::filesystem::u8path(prerequisite));
+
+      tokens.clear();
+      separated = false;
+    };
+
+    for (std::size_t index = 0; index < content.length(); ++index) {
+      auto const ch   = content[index];
+      auto const next = index + 1 < content.length() ? content[index + 1] : '\n';
+
+      if (ch == '\\' and (next == '\n' or next == '\r')) {
+        // a continued line
+        end_token();
+        index += next == '\r' and index + 2 < content.length() and content[index + 2] == '\n' ? 2 : 1;
+      }
+      else if (ch == '\\' and (next == ' ' or next == '#'))
+        token.push_back(content[++index]);
+      else if (ch == '$' and next == '$')
+        token.push_back(content[++index]);
+      else if (ch == ':' and not separated and is_space(next)) {
+        // the targets precede the first colon which ends a token, unlike the one of a drive
+        end_token();
+        tokens.clear();
+        separated = true;
+      }
+      else if (ch == '\n')
+        end_rule();
+      else if (is_space(ch))
+        end_token();
+      else
+        token.push_back(ch);
+    }
+
+    end_rule();
+    return prerequisites;
+  }
+
+  auto to_depfile(std::filesystem::path const& target, std::vector<std::filesystem::path> const& prerequisites)
+  -> std::string {
+    auto const escaped = [](std::filesystem::path const& file) {
+      auto text = std::string{};
+      for (auto const ch : file.generic_u8string()) {
+        if (ch == ' ' or ch == '#')
+          text.push_back('\\');
+        else if (ch == '$')
+          text.push_back('$');
+
+        text.push_back(ch);
+      }
+
+      return text;
+    };
+
+    auto depfile = escaped(target) + ':';
+    for (auto const& prerequisite : prerequisites)
+      depfile += " \\\n  " + escaped(prerequisite);
+
+    return depfile + '\n';
+  }
+
+  auto sources(std::vector<command> const& commands, selection const& selected) -> std::vector<std::filesystem::path> {
+    auto const root            = selected.root.lexically_normal();
+    auto const build_directory = selected.build_directory.lexically_normal();
+
+    auto found = std::vector<std::filesystem::path>{};
+    auto seen  = std::unordered_set<std::string>{};
+
+    auto const add = [&](std::filesystem::path const& file) {
+      if (not root.empty() and not within(file, root))
+        return;
+
+      if (not build_directory.empty() and build_directory != root and within(file, build_directory))
+        return;
+
+      if (seen.insert(file.generic_u8string()).second)
+        found.push_back(file);
+    };
+
+    auto const selected_commands = chosen(commands, selected.target);
+
+    for (auto const compiled : selected_commands)
+      add(compiled->file);
+
+    if (selected.headers)
+      for (auto const compiled : selected_commands) {
+        auto const depfile = depfile_of(*compiled);
+
+        // there are none before the first build
+        if (not depfile or not std::filesystem::exists(*depfile))
+          continue;
+
+        for (auto const& prerequisite : parse_depfile(io::content(*depfile)))
+          add((compiled->directory / prerequisite).lexically_normal());
+      }
+
+    return found;
+  }
+
+  auto depfiles(std::vector<command> const& commands, selection const& selected) -> std::vector<std::filesystem::path> {
+    auto found = std::vector<std::filesystem::path>{};
+
+    for (auto const compiled : chosen(commands, selected.target))
+      if (auto depfile = depfile_of(*compiled))
+        found.push_back(std::move(*depfile));
+
+    return found;
+  }
+} // namespace generator::compilation
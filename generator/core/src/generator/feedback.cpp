@@ -21,6 +21,19 @@ namespace generator::feedback {
                       response);
   }
 
+  auto relevance_of(handling const& handling, bool changed, bool baseline) -> relevance {
+    if (std::holds_alternative<feedback::none>(handling.response))
+      return relevance{};
+
+    auto const source = baseline or changed;
+
+    return std::visit(overloaded{ [&](feedback::nothing) { return relevance{}; },
+                                  [&](feedback::changed_lines) { return relevance{ source, baseline }; },
+                                  [&](feedback::changed_files) { return relevance{ source, true }; },
+                                  [&](feedback::everything) { return relevance{ true, true }; } },
+                      handling.check);
+  }
+
   workflow::workflow(feedback::handlings handlings) noexcept : handlings_(std::move(handlings)) {
   }
 
@@ -0,0 +1,55 @@
+#include "generator/format.h"
+
+#if defined __SSE2__ or defined _M_X64 or (defined _M_IX86_FP and _M_IX86_FP >= 2)
+#define GENERATOR_FORMAT_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace generator::format {
+
+  namespace {
+    constexpr auto is_escaped(char ch) noexcept {
+      return ch == '\n' or ch == '\r' or ch == '\\' or ch == '"';
+    }
+
+#ifdef GENERATOR_FORMAT_SSE2
+    auto first_set_bit(unsigned mask) noexcept -> int {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<int>(index);
+#else
+      return __builtin_ctz(mask);
+#endif
+    }
+#endif
+  } // namespace
+
+  auto find_escaped(char const* first, char const* last) noexcept -> char const* {
+#ifdef GENERATOR_FORMAT_SSE2
+    auto const newline         = _mm_set1_epi8('\n');
+    auto const carriage_return = _mm_set1_epi8('\r');
+    auto const backslash       = _mm_set1_epi8('\\');
+    auto const quote           = _mm_set1_epi8('"');
+
+    for (; last - first >= 16; first += 16) {
+      auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+      auto const found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, carriage_return)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(block, backslash), _mm_cmpeq_epi8(block, quote)));
+
+      if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(found)))
+        return first + first_set_bit(mask);
+    }
+#endif
+
+    for (; first != last; ++first)
+      if (is_escaped(*first))
+        return first;
+
+    return last;
+  }
+} // namespace generator::format
@@ -1,7 +1,26 @@
 #include "generator/io.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
 #include <sstream>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#define popen  _popen
+#define pclose _pclose
+#else
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 namespace generator::io {
   auto content(std::filesystem::path const& filename) -> std::string {
@@ -12,4 +31,245 @@ namespace generator::io {
     content << std::ifstream{ filename }.rdbuf();
     return content.str();
   }
+
+  auto binary_content(std::filesystem::path const& filename) -> std::string {
+    if (!std::filesystem::exists(filename))
+      throw std::invalid_argument{ "file not found" };
+
+    std::ostringstream content;
+    content << std::ifstream{ filename, std::ios::binary }.rdbuf();
+    return content.str();
+  }
+
+  void replace_content(std::filesystem::path const& filename, std::string_view content) {
+    // concurrent writers each use their own temporary file, the rename replaces the content atomically
+    auto const unique    = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                        static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    auto       temporary = filename;
+    temporary += ".tmp" + std::to_string(unique);
+
+    {
+      auto out = std::ofstream{ temporary, std::ios::binary | std::ios::trunc };
+      out.write(content.data(), static_cast<std::streamsize>(content.size()));
+
+      if (not out)
+        throw std::runtime_error{ "failed to write file: " + temporary.u8string() };
+    }
+
+    std::filesystem::rename(temporary, filename);
+  }
+
+  window_reader::window_reader(std::filesystem::path const& filename, std::size_t window_size)
+  : in_(filename), window_size_(std::max(window_size, std::size_t{ 1 })) {
+    if (not in_)
+      throw std::invalid_argument{ "file not found" };
+  }
+
+  auto window_reader::next() -> std::optional<text::window> {
+    // the previous window is dropped except for its last byte, which remains as context
+    auto const next_begin = text_begin_ + own_length_;
+    auto const kept_begin = next_begin > 0 ? next_begin - 1 : 0;
+
+    preceding_lines_ += std::count(buffer_.data() + text_begin_, buffer_.data() + next_begin, '\n');
+    offset_ += own_length_;
+
+    buffer_.erase(0, kept_begin);
+    text_begin_ = next_begin - kept_begin;
+
+    // a window, its overlap and one byte of context to tell whether the text ends there
+    auto const wanted = text_begin_ + 2 * window_size_ + 1;
+    while (buffer_.size() < wanted and in_) {
+      auto const size = buffer_.size();
+      buffer_.resize(wanted);
+      in_.read(buffer_.data() + size, static_cast<std::streamsize>(wanted - size));
+      buffer_.resize(size + static_cast<std::size_t>(in_.gcount()));
+    }
+
+    auto const available = buffer_.size() - text_begin_;
+    if (available == 0) {
+      own_length_ = 0;
+      return std::nullopt;
+    }
+
+    // only the rest of the file can be shorter than a window, since a window and its overlap are read ahead
+    auto const unread = std::string_view{ buffer_ }.substr(text_begin_);
+    own_length_       = text::window_length(unread, window_size_);
+
+    auto const text_length = std::min(available, own_length_ + window_size_);
+    return text::window{ buffer_, unread.substr(0, text_length), own_length_, preceding_lines_, offset_ };
+  }
+
+  auto command_output(std::string const& command) -> std::string {
+#ifdef _WIN32
+    auto const mode = "rb";
+#else
+    auto const mode = "r";
+#endif
+
+    auto pipe = std::unique_ptr<FILE, int (*)(FILE*)>{ popen(command.c_str(), mode), pclose };
+    if (not pipe)
+      throw std::runtime_error{ "failed to run command: " + command };
+
+    std::string             output;
+    std::array<char, 65536> buffer;
+
+    while (auto const count = std::fread(buffer.data(), 1, buffer.size(), pipe.get()))
+      output.append(buffer.data(), count);
+
+    if (pclose(pipe.release()) != 0)
+      throw std::runtime_error{ "command failed: " + command };
+
+    return output;
+  }
+
+  chunk_writer::chunk_writer(std::ostream& out, std::size_t capacity) : out_(out), capacity_(capacity) {
+    counters_.capacity = capacity;
+
+#ifndef _WIN32
+    if (&out == &std::cout) {
+      std::cout.flush();
+      fd_ = STDOUT_FILENO;
+    }
+#endif
+
+    thread_ = std::thread{ [this] { run(); } };
+  }
+
+  chunk_writer::~chunk_writer() {
+    {
+      auto const locked = std::lock_guard{ mutex_ };
+      stopping_         = true;
+    }
+
+    submitted_.notify_one();
+    thread_.join();
+  }
+
+  auto chunk_writer::acquire() -> chunk {
+    auto const locked = std::lock_guard{ mutex_ };
+    if (spare_.empty())
+      return chunk{};
+
+    auto recycled = std::move(spare_.back());
+    spare_.pop_back();
+    return recycled;
+  }
+
+  void chunk_writer::submit(chunk&& written) {
+    {
+      auto locked = std::unique_lock{ mutex_ };
+
+      if (capacity_ > 0 and pending_.size() >= capacity_) {
+        ++counters_.blocked;
+        written_.wait(locked, [this] { return pending_.size() < capacity_; });
+      }
+
+      pending_.push_back(std::move(written));
+      ++counters_.pushed;
+      counters_.peak = std::max(counters_.peak, pending_.size());
+    }
+
+    submitted_.notify_one();
+  }
+
+  auto chunk_writer::counters() const -> container::occupancy {
+    auto const locked = std::lock_guard{ mutex_ };
+    return counters_;
+  }
+
+  void chunk_writer::flush() {
+    auto locked = std::unique_lock{ mutex_ };
+    written_.wait(locked, [this] { return pending_.empty() and not writing_; });
+
+    if (error_)
+      std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+  void chunk_writer::run() {
+    auto batch  = std::vector<chunk>{};
+    auto locked = std::unique_lock{ mutex_ };
+
+    while (true) {
+      if (not stopping_ and pending_.empty())
+        ++counters_.starved;
+
+      submitted_.wait(locked, [this] { return stopping_ or not pending_.empty(); });
+
+      if (pending_.empty())
+        return;
+
+      swap(batch, pending_);
+      writing_ = true;
+
+      // waiting submitters continue while the batch is written
+      written_.notify_all();
+
+      // after a failed write the remaining output is discarded until flush reports the failure
+      auto const failed = bool{ error_ };
+      auto       error  = std::exception_ptr{};
+
+      locked.unlock();
+
+      try {
+        if (not failed)
+          write(batch);
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+
+      locked.lock();
+      writing_ = false;
+
+      if (error)
+        error_ = error;
+
+      for (auto& recycled : batch) {
+        recycled.clear();
+        spare_.push_back(std::move(recycled));
+      }
+
+      batch.clear();
+      written_.notify_all();
+    }
+  }
+
+  void chunk_writer::write(std::vector<chunk> const& batch) {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+      constexpr auto max_count = std::size_t{ IOV_MAX < 1024 ? IOV_MAX : 1024 };
+
+      auto vectors = std::vector<iovec>{};
+      for (auto const& written : batch)
+        if (written.size() > 0)
+          vectors.push_back({ const_cast<char*>(written.data()), written.size() });
+
+      for (auto first = vectors.begin(); first != vectors.end();) {
+        auto const count   = std::min<std::size_t>(max_count, static_cast<std::size_t>(vectors.end() - first));
+        auto       written = ::writev(fd_, &*first, static_cast<int>(count));
+
+        if (written < 0 and errno == EINTR)
+          continue;
+        if (written < 0)
+          throw std::runtime_error{ "failed to write the output" };
+
+        // skip the completely written vectors and adjust a partially written one
+        while (first != vectors.end() and static_cast<std::size_t>(written) >= first->iov_len) {
+          written -= static_cast<ssize_t>(first->iov_len);
+          ++first;
+        }
+
+        if (first != vectors.end()) {
+          first->iov_base = static_cast<char*>(first->iov_base) + written;
+          first->iov_len -= static_cast<std::size_t>(written);
+        }
+      }
+
+      return;
+    }
+#endif
+
+    for (auto const& written : batch)
+      out_.write(written.data(), static_cast<std::streamsize>(written.size()));
+  }
 } // namespace generator::io
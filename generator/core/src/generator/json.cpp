@@ -1,7 +1,16 @@
 #include "generator/json.h"
 
+#include "generator/allocation.h"
+
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <execution>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace generator::feedback {
   namespace {
     template <class V, std::size_t... Index>
@@ -12,6 +21,31 @@ namespace generator::feedback {
     template <class V> auto all_variant_values() {
       return get_variant_values<V>(std::make_index_sequence<std::variant_size_v<V>>{});
     }
+
+    auto scope_of(nlohmann::json const& json) -> lexer::regions {
+      if (json.is_string())
+        return lexer::to_regions(json.get<std::string>());
+
+      auto scope = lexer::regions{ 0 };
+      for (auto const& name : json)
+        scope |= lexer::to_regions(name.get<std::string>());
+
+      return scope;
+    }
+
+    // a regex by default or a builtin kernel, which replaces the matched text
+    auto matched_text_of(nlohmann::json const& json) -> regex::precompiled {
+      auto const engine = json.value("engine", std::string{ "regex" });
+      auto const prefix = std::string_view{ "builtin:" };
+
+      if (engine == "regex")
+        return regex::capture(json.at("matched_text").get<std::string>());
+
+      if (engine.compare(0, prefix.length(), prefix) == 0)
+        return regex::builtin(std::string_view{ engine }.substr(prefix.length()));
+
+      throw std::invalid_argument{ "unknown engine: " + engine };
+    }
   } // namespace
 
   void from_json(nlohmann::json const& json, feedback::check& check) {
@@ -30,22 +64,74 @@ namespace generator::feedback {
   }
 
   void from_json(nlohmann::json const& json, feedback::rule& rule) {
-    rule.type          = json.at("type");
-    rule.summary       = json.at("summary");
-    rule.rationale     = json.value("rationale", "N/A");
-    rule.workaround    = json.value("workaround", "N/A");
-    rule.matched_files = regex::capture(json.value("matched_files", ".*"));
-    rule.ignored_files = regex::capture(json.value("ignored_files", "^$"));
-    rule.matched_text  = regex::capture(json.at("matched_text").get<std::string>());
-    rule.ignored_text  = regex::capture(json.value("ignored_text", "^$"));
-    rule.marked_text   = regex::capture(json.value("marked_text", ".*"));
+    rule.type                  = json.at("type");
+    rule.summary               = json.at("summary");
+    rule.rationale             = json.value("rationale", "N/A");
+    rule.workaround            = json.value("workaround", "N/A");
+    rule.matched_files         = regex::capture(json.value("matched_files", ".*"));
+    rule.ignored_files         = regex::capture(json.value("ignored_files", "^$"));
+    rule.matched_text          = matched_text_of(json);
+    rule.ignored_text          = regex::capture(json.value("ignored_text", "^$"));
+    rule.marked_text           = regex::capture(json.value("marked_text", ".*"));
+    rule.scope                 = scope_of(json.value("scope", nlohmann::json("any")));
+    rule.max_match_lines       = std::max(json.value("max_match_lines", 1), 1);
+    rule.max_match_length      = json.value("max_match_length", std::size_t{ 0 });
+    rule.max_findings_per_file = json.value("max_findings_per_file", std::size_t{ 0 });
   }
 } // namespace generator::feedback
 
 namespace generator::json {
 
-  auto parse_rules(std::string_view json) -> feedback::rules {
-    return nlohmann::json::parse(json).get<feedback::rules>();
+  namespace {
+    auto is_disabled(feedback::handling const& handling) {
+      return std::holds_alternative<feedback::nothing>(handling.check) or
+             std::holds_alternative<feedback::none>(handling.response);
+    }
+
+    struct parsed_rule {
+      std::string const&    id;
+      nlohmann::json const& json;
+      feedback::rule        rule{};
+      std::exception_ptr    error{};
+    };
+  } // namespace
+
+  auto parse_rules(std::string_view json, feedback::workflow const& workflow) -> feedback::rules {
+    auto const rules = nlohmann::json::parse(json);
+
+    // rules disabled by the workflow can never fire, so we don't even compile them
+    auto parsed_rules = std::vector<parsed_rule>{};
+    for (auto const& [id, rule] : rules.get_ref<nlohmann::json::object_t const&>())
+      if (not rule.contains("type") or not is_disabled(workflow[rule.at("type").get<std::string>()]))
+        parsed_rules.push_back({ id, rule });
+
+    // the rules are compiled on the workers of the parallel algorithms, whose allocations belong to the caller's phase
+    auto const phase = allocation::current_phase();
+    std::for_each(std::execution::par, begin(parsed_rules), end(parsed_rules), [phase](parsed_rule& parsed) {
+      auto const in_phase = allocation::scope{ phase };
+
+      try {
+        parsed.json.get_to(parsed.rule);
+      }
+      catch (...) {
+        parsed.error = std::current_exception();
+      }
+    });
+
+    auto compiled_rules = feedback::rules{};
+    for (auto& parsed : parsed_rules) {
+      try {
+        if (parsed.error)
+          std::rethrow_exception(parsed.error);
+      }
+      catch (std::exception const& e) {
+        throw std::invalid_argument{ "rule " + parsed.id + ": " + e.what() };
+      }
+
+      compiled_rules.emplace(parsed.id, std::move(parsed.rule));
+    }
+
+    return compiled_rules;
   }
   auto parse_workflow(std::string_view json) -> feedback::workflow {
     return feedback::workflow{ nlohmann::json::parse(json).get<feedback::handlings>() };
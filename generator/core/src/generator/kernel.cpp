@@ -0,0 +1,190 @@
+#include "generator/kernel.h"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if defined __SSE2__ or defined _M_X64 or (defined _M_IX86_FP and _M_IX86_FP >= 2)
+#define GENERATOR_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace generator::kernel {
+
+  namespace {
+    constexpr auto is_blank(char ch) noexcept {
+      return ch == ' ' or ch == '\t';
+    }
+
+    constexpr auto is_non_ascii(char ch) noexcept {
+      return static_cast<unsigned char>(ch) >= 0x80;
+    }
+
+#ifdef GENERATOR_KERNEL_SSE2
+    auto first_set_bit(unsigned mask) noexcept -> int {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<int>(index);
+#else
+      return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    // the first of two bytes in [first, last) or last, scanning blocks of 16 bytes at once
+    auto find_either(char const* first, char const* last, char one, char other) noexcept -> char const* {
+#ifdef GENERATOR_KERNEL_SSE2
+      auto const ones   = _mm_set1_epi8(one);
+      auto const others = _mm_set1_epi8(other);
+
+      for (; last - first >= 16; first += 16) {
+        auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        auto const found = _mm_or_si128(_mm_cmpeq_epi8(block, ones), _mm_cmpeq_epi8(block, others));
+
+        if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(found)))
+          return first + first_set_bit(mask);
+      }
+#endif
+
+      for (; first != last; ++first)
+        if (*first == one or *first == other)
+          return first;
+
+      return last;
+    }
+
+    auto find_newline(char const* first, char const* last) noexcept -> char const* {
+      return find_either(first, last, '\n', '\n');
+    }
+
+    // the first byte of [first, last) with its high bit set or last; the sign bits of a block are its mask already
+    auto find_non_ascii(char const* first, char const* last) noexcept -> char const* {
+#ifdef GENERATOR_KERNEL_SSE2
+      for (; last - first >= 16; first += 16) {
+        auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+
+        if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(block)))
+          return first + first_set_bit(mask);
+      }
+#endif
+
+      return std::find_if(first, last, is_non_ascii);
+    }
+
+    auto parse_max_line_length(std::string_view name) -> std::size_t {
+      auto const digits = name.substr(std::min(name.find(':'), name.length() - 1) + 1);
+      auto       max    = std::size_t{ 0 };
+      auto const result = std::from_chars(digits.data(), digits.data() + digits.length(), max);
+
+      if (result.ec != std::errc{} or result.ptr != digits.data() + digits.length())
+        throw std::invalid_argument{ "invalid builtin engine: " + std::string{ name } };
+
+      return max;
+    }
+
+    auto match(char const* first, char const* last) noexcept {
+      return std::optional<std::string_view>{ std::string_view{ first, static_cast<std::size_t>(last - first) } };
+    }
+  } // namespace
+
+  builtin::builtin(std::string_view name) {
+    if (name == "tab")
+      check_ = check::tab;
+    else if (name == "trailing_whitespace")
+      check_ = check::trailing_whitespace;
+    else if (name == "crlf")
+      check_ = check::crlf;
+    else if (name == "non_ascii")
+      check_ = check::non_ascii;
+    else if (name.substr(0, name.find(':')) == "long_line") {
+      check_           = check::long_line;
+      max_line_length_ = parse_max_line_length(name);
+    }
+    else
+      throw std::invalid_argument{ "unknown builtin engine: " + std::string{ name } };
+  }
+
+  auto builtin::find(std::string_view input, std::string_view context) const noexcept -> std::optional<std::string_view> {
+    auto const first       = input.data();
+    auto const last        = input.data() + input.length();
+    auto const context_end = context.data() + context.length();
+
+    switch (check_) {
+    case check::tab: {
+      auto const tab = find_either(first, last, '\t', '\t');
+      if (tab != last)
+        return match(tab, tab + 1);
+      break;
+    }
+
+    case check::crlf:
+      for (auto cr = find_either(first, last, '\r', '\r'); cr != last; cr = find_either(cr + 1, last, '\r', '\r'))
+        if (cr + 1 != context_end and cr[1] == '\n')
+          return match(cr, cr + 1);
+      break;
+
+    case check::non_ascii: {
+      auto const begin = find_non_ascii(first, last);
+      if (begin != last)
+        return match(begin, std::find_if_not(begin, last, is_non_ascii));
+      break;
+    }
+
+    case check::trailing_whitespace:
+      for (auto line = first; line != last;) {
+        auto const newline = find_newline(line, last);
+
+        // a line continuing behind the input is checked in the next one
+        if (newline == last and last != context_end)
+          break;
+
+        auto end = newline;
+        if (end != line and end[-1] == '\r')
+          --end;
+
+        auto begin = end;
+        while (begin != line and is_blank(begin[-1]))
+          --begin;
+
+        if (begin != end)
+          return match(begin, end);
+
+        line = newline == last ? last : newline + 1;
+      }
+      break;
+
+    case check::long_line: {
+      auto const preceding  = std::string_view{ context.data(), static_cast<std::size_t>(first - context.data()) };
+      auto const line_break = preceding.rfind('\n');
+      auto       line_start = line_break == std::string_view::npos ? context.data() : context.data() + line_break + 1;
+
+      for (auto line = first; line != last;) {
+        auto const newline = find_newline(line, last);
+
+        auto end = newline;
+        if (end != line and end[-1] == '\r')
+          --end;
+
+        if (static_cast<std::size_t>(end - line_start) > max_line_length_) {
+          auto const begin = std::max(line_start + max_line_length_, line);
+          if (begin < end)
+            return match(begin, end);
+        }
+
+        line       = newline == last ? last : newline + 1;
+        line_start = line;
+      }
+      break;
+    }
+    }
+
+    return std::nullopt;
+  }
+} // namespace generator::kernel
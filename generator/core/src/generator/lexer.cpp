@@ -0,0 +1,221 @@
+#include "generator/lexer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace generator::lexer {
+
+  namespace {
+    constexpr auto is_identifier(char ch) noexcept {
+      return (ch >= 'a' and ch <= 'z') or (ch >= 'A' and ch <= 'Z') or (ch >= '0' and ch <= '9') or ch == '_';
+    }
+
+    constexpr auto is_digit(char ch) noexcept {
+      return ch >= '0' and ch <= '9';
+    }
+
+    constexpr auto is_space(char ch) noexcept {
+      return ch == ' ' or ch == '\t' or ch == '\r' or ch == '\f' or ch == '\v';
+    }
+
+    // a backslash before the line break continues the line, optionally followed by a carriage return
+    auto is_continued(std::string_view source, std::size_t newline) noexcept {
+      if (newline > 0 and source[newline - 1] == '\r')
+        --newline;
+      return newline > 0 and source[newline - 1] == '\\';
+    }
+
+    auto end_of_line(std::string_view source, std::size_t offset) noexcept {
+      auto newline = source.find('\n', offset);
+      while (newline != std::string_view::npos and is_continued(source, newline))
+        newline = source.find('\n', newline + 1);
+
+      return newline == std::string_view::npos ? source.size() : newline;
+    }
+
+    // the quote at offset opens a raw string literal if preceded by R, u8R, uR, UR or LR
+    auto is_raw_string(std::string_view source, std::size_t quote) noexcept {
+      if (quote == 0 or source[quote - 1] != 'R')
+        return false;
+
+      auto first = quote - 1;
+      while (first > 0 and is_identifier(source[first - 1]))
+        --first;
+
+      auto const prefix = source.substr(first, quote - 1 - first);
+      return prefix.empty() or prefix == "u8" or prefix == "u" or prefix == "U" or prefix == "L";
+    }
+
+    auto end_of_raw_string(std::string_view source, std::size_t quote) noexcept {
+      auto const open = source.find('(', quote);
+      if (open == std::string_view::npos)
+        return source.size();
+
+      auto const delimiter = std::string{ ")" }.append(source.substr(quote + 1, open - quote - 1)).append("\"");
+      auto const close     = source.find(delimiter, open);
+
+      return close == std::string_view::npos ? source.size() : close + delimiter.size();
+    }
+
+    auto end_of_quoted(std::string_view source, std::size_t quote) noexcept {
+      auto offset = quote + 1;
+      while (offset < source.size()) {
+        auto const ch = source[offset];
+        if (ch == '\\')
+          offset += 2;
+        else if (ch == source[quote])
+          return offset + 1;
+        else if (ch == '\n')
+          return offset;
+        else
+          ++offset;
+      }
+
+      return source.size();
+    }
+
+    auto is_header_directive(std::string_view source, std::size_t hash) noexcept {
+      auto first = hash + 1;
+      while (first < source.size() and is_space(source[first]))
+        ++first;
+
+      auto last = first;
+      while (last < source.size() and is_identifier(source[last]))
+        ++last;
+
+      auto const directive = source.substr(first, last - first);
+      return directive == "include" or directive == "include_next" or directive == "import";
+    }
+  } // namespace
+
+  auto to_regions(std::string_view name) -> regions {
+    if (name == "code")
+      return code;
+    if (name == "comment")
+      return comment;
+    if (name == "string")
+      return string;
+    if (name == "preprocessor")
+      return preprocessor;
+    if (name == "any")
+      return any;
+
+    throw std::invalid_argument{ "unknown scope: " + std::string{ name } };
+  }
+
+  mask::mask(std::string_view source) {
+    auto at_line_start = true;
+    auto in_directive  = false;
+    auto header_name   = false;
+    auto in_number     = false;
+
+    auto const outside = [&] { return in_directive ? preprocessor : code; };
+
+    mark(0, code);
+
+    for (std::size_t offset = 0; offset < source.size();) {
+      auto const ch   = source[offset];
+      auto const next = offset + 1 < source.size() ? source[offset + 1] : '\0';
+
+      if (ch == '\n') {
+        if (not is_continued(source, offset)) {
+          in_directive  = false;
+          header_name   = false;
+          at_line_start = true;
+          mark(offset, code);
+        }
+
+        in_number = false;
+        ++offset;
+        continue;
+      }
+
+      if (is_space(ch)) {
+        in_number = false;
+        ++offset;
+        continue;
+      }
+
+      if (ch == '#' and at_line_start) {
+        in_directive  = true;
+        header_name   = is_header_directive(source, offset);
+        at_line_start = false;
+        mark(offset, preprocessor);
+        ++offset;
+        continue;
+      }
+
+      if (ch == '/' and (next == '/' or next == '*')) {
+        mark(offset, comment);
+
+        if (next == '/') {
+          offset = end_of_line(source, offset);
+        }
+        else {
+          auto const close = source.find("*/", offset + 2);
+          offset           = close == std::string_view::npos ? source.size() : close + 2;
+        }
+
+        mark(offset, outside());
+        in_number = false;
+        continue;
+      }
+
+      at_line_start = false;
+
+      if (ch == '<' and header_name) {
+        auto const close = source.find_first_of(">\n", offset);
+        offset           = close == std::string_view::npos or source[close] == '\n' ? offset + 1 : close + 1;
+        continue;
+      }
+
+      if (ch == '"' or (ch == '\'' and not in_number)) {
+        // literals in directives belong to the directive, like the header names of include directives
+        if (not in_directive)
+          mark(offset, string);
+
+        offset = ch == '"' and is_raw_string(source, offset) ? end_of_raw_string(source, offset) : end_of_quoted(source, offset);
+
+        mark(offset, outside());
+        in_number = false;
+        continue;
+      }
+
+      if (is_identifier(ch)) {
+        // digit separators like in 0x1'FFFF continue a number
+        if (not in_number)
+          in_number = is_digit(ch) and (offset == 0 or not is_identifier(source[offset - 1]));
+      }
+      else if (ch != '\'' and not (ch == '.' and in_number)) {
+        in_number = false;
+      }
+
+      ++offset;
+    }
+  }
+
+  auto mask::operator[](std::size_t offset) const noexcept -> regions {
+    auto const run = std::upper_bound(begin(starts_), end(starts_), offset);
+    return regions_[static_cast<std::size_t>(run - begin(starts_)) - 1];
+  }
+
+  void mask::mark(std::size_t offset, regions region) {
+    if (not regions_.empty() and regions_.back() == region)
+      return;
+
+    if (not starts_.empty() and starts_.back() == offset) {
+      regions_.back() = region;
+
+      // merging with the run before keeps the runs canonical
+      if (regions_.size() > 1 and regions_[regions_.size() - 2] == region) {
+        starts_.pop_back();
+        regions_.pop_back();
+      }
+      return;
+    }
+
+    starts_.push_back(offset);
+    regions_.push_back(region);
+  }
+} // namespace generator::lexer
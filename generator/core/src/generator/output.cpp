@@ -1,19 +1,31 @@
 #include "generator/output.h"
 
+#include "generator/allocation.h"
 #include "generator/container.h"
 #include "generator/format.h"
 #include "generator/io.h"
+#include "generator/lexer.h"
 #include "generator/text.h"
 
-#include <cxx20/syncstream>
-
 #include <algorithm>
 #include <any>
+#include <array>
+#include <cstddef>
+#include <exception>
 #include <execution>
 #include <fstream>
 #include <future>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 using fmt::operator""_a;
 
@@ -24,8 +36,9 @@ namespace generator::output {
     template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
   } // namespace
 
+  // a baseline replaces the diff, which is not even passed then, so its checks of changes apply to whole sources
   auto make_relevant_matches(std::shared_future<feedback::workflow> const& shared_workflow,
-                             std::shared_future<scm::diff> const&          shared_diff) {
+                             std::shared_future<scm::diff> const& shared_diff, bool baseline) {
     return [=](std::filesystem::path const& source) {
       auto const shared_source_changes =
       std::async(std::launch::async, [=] { return shared_diff.get().changes_from(source); }).share();
@@ -37,29 +50,18 @@ namespace generator::output {
         auto const rule_ignored_filename = attributes.ignored_files.matches(source.generic_u8string());
 
         auto file_is_relevant = rule_matched_filename and not rule_ignored_filename;
-        auto line_is_relevant = std::function<bool(int)>{ [](auto) { return true; } };
+        auto line_is_relevant = std::function<bool(int)>{ [](auto) { return false; } };
 
         if (file_is_relevant) {
-          auto const& workflow = shared_workflow.get();
-
-          std::visit(overloaded{
-                     [&](feedback::nothing) { file_is_relevant = false; },
-                     [&](feedback::changed_lines) {
-                       line_is_relevant = [is_modified = shared_source_changes.get()](auto line) {
-                         return is_modified[line];
-                       };
-                       file_is_relevant = not shared_source_changes.get().empty();
-                     },
-                     [&](feedback::changed_files) { file_is_relevant = not shared_source_changes.get().empty(); },
-                     [&](feedback::everything) {} },
-                     workflow[attributes.type].check);
-
-          if (std::holds_alternative<feedback::none>(workflow[attributes.type].response))
-            file_is_relevant = false;
-        }
-
-        if (!file_is_relevant) {
-          line_is_relevant = [](auto) { return false; };
+          auto const& changes  = shared_source_changes.get();
+          auto const  handling = shared_workflow.get()[attributes.type];
+          auto const  relevant = feedback::relevance_of(handling, not changes.empty(), baseline);
+
+          file_is_relevant = relevant.source;
+          if (relevant.source and relevant.all_lines)
+            line_is_relevant = [](auto) { return true; };
+          else if (relevant.source)
+            line_is_relevant = [is_modified = changes](auto line) { return is_modified[line]; };
         }
 
         return overloaded{ [=]() { return file_is_relevant; }, [=](auto line) { return line_is_relevant(line); } };
@@ -67,6 +69,77 @@ namespace generator::output {
     };
   }
 
+  // admits findings up to the configured limits; all outstanding tasks are cancelled cooperatively as soon as a limit is
+  // reached, since a run which reached --max-errors fails whatever the remaining sources contain
+  class finding_budget {
+  public:
+    explicit finding_budget(output::options const& options) noexcept
+    : max_findings(options.max_findings), max_errors(options.max_errors) {
+    }
+
+    auto admit(bool is_error) noexcept -> bool {
+      if (exhausted()) {
+        suppressed_finding = true;
+        return false;
+      }
+
+      if (not admit(findings, max_findings, "--max-findings"))
+        return false;
+
+      return not is_error or admit(errors, max_errors, "--max-errors");
+    }
+
+    auto exhausted() const noexcept -> bool {
+      return reached_limit.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // a cancelled task reports whether it left work undone, so that the notes tell a suppressed finding from a skipped
+    // scan and a run with exactly as many findings as a limit gets no note
+    void skip() noexcept {
+      skipped_work = true;
+    }
+
+    auto suppressed() const noexcept -> bool {
+      return suppressed_finding;
+    }
+
+    auto skipped() const noexcept -> bool {
+      return skipped_work;
+    }
+
+    // the option whose limit was reached, nullptr if none
+    auto reached() const noexcept -> std::string_view {
+      auto const* limit = reached_limit.load();
+      return limit ? limit : std::string_view{};
+    }
+
+  private:
+    auto admit(std::atomic_size_t& count, std::size_t limit, char const* option) noexcept -> bool {
+      if (limit == 0)
+        return true;
+
+      auto const admitted = count.fetch_add(1, std::memory_order_relaxed) < limit;
+      if (not admitted)
+        suppressed_finding = true;
+
+      // the last admitted finding already reaches the limit
+      if (count.load(std::memory_order_relaxed) >= limit) {
+        char const* none = nullptr;
+        reached_limit.compare_exchange_strong(none, option);
+      }
+
+      return admitted;
+    }
+
+    std::size_t const         max_findings;
+    std::size_t const         max_errors;
+    std::atomic_size_t        findings{ 0 };
+    std::atomic_size_t        errors{ 0 };
+    std::atomic<char const*>  reached_limit{ nullptr };
+    std::atomic_bool          suppressed_finding{ false };
+    std::atomic_bool          skipped_work{ false };
+  };
+
   struct header {
     std::filesystem::path const&                  rules_origin;
     std::shared_future<feedback::rules> const&    shared_rules;
@@ -85,18 +158,89 @@ namespace generator::output {
     std::shared_future<feedback::workflow> const& shared_workflow;
   };
 
+  // the feedback text of each rule, which is the same for all of its findings, rendered and escaped once per run
+  using rendered_feedback = std::unordered_map<feedback::rule const*, std::string>;
+
+  auto render(feedback::rules const& rules, std::filesystem::path const& rules_origin) -> rendered_feedback {
+    auto       rendered = rendered_feedback{};
+    auto const origin   = rules_origin.generic_u8string();
+
+    for (auto const& [id, attributes] : rules) {
+      auto const text = fmt::format("{id}: {summary} [ {type} from file://{origin} ]\nrationale  : "
+                                    "{rationale}\nworkaround : {workaround}",
+                                    "id"_a = id, "type"_a = attributes.type, "summary"_a = attributes.summary,
+                                    "rationale"_a = attributes.rationale, "workaround"_a = attributes.workaround,
+                                    "origin"_a = origin);
+
+      rendered.emplace(&attributes, fmt::format("{}", format::as_compiler_message{ text }));
+    }
+
+    return rendered;
+  }
+
+  // the findings after a cap, which are only counted and summarized by a single note
+  struct suppressed_findings {
+    void add(int line) noexcept {
+      merge({ 1, line, line });
+    }
+
+    void merge(suppressed_findings const& other) noexcept {
+      if (other.count == 0)
+        return;
+
+      first_line = count == 0 ? other.first_line : std::min(first_line, other.first_line);
+      last_line  = count == 0 ? other.last_line : std::max(last_line, other.last_line);
+      count += other.count;
+    }
+
+    std::size_t count{ 0 };
+    int         first_line{ 0 };
+    int         last_line{ 0 };
+  };
+
+  // what a rule carries over from one window of a source to the next
+  struct rule_progress {
+    std::size_t         resumed{ 0 }; // where the rule resumes in the next window after a match reaching into the overlap
+    std::size_t         emitted{ 0 };
+    bool                capped{ false }; // no further findings after reaching the limit of the rule in the source
+    suppressed_findings suppressed;
+  };
+
+  // the findings emitted in a source, whose rules may run in parallel and its windows one after the other
+  struct source_progress {
+    std::unordered_map<std::string, rule_progress> rules; // empty for sources scanned as a whole
+    std::atomic_size_t                             emitted{ 0 };
+    std::atomic_bool                               capped{ false };
+    std::mutex                                     suppressed_lock;
+    suppressed_findings                            suppressed;
+  };
+
   struct rule_in_source_matches {
     std::filesystem::path const&                  rules_origin;
     feedback::rules::value_type const&            rule;
-    std::shared_future<std::string> const&        shared_source;
     std::shared_future<feedback::workflow> const& shared_workflow;
+    finding_budget&                               budget;
+    std::function<lexer::mask const&()> const&    source_mask;
+    output::options const&                        options;
+    std::string const&                            fingerprint_file;
+    rule_progress&                                progress;
+    source_progress&                              in_source;
+    std::size_t                                   max_candidates; // enough to reach the limits of the source
+    std::string_view                              feedback;
   };
 
+  // a source as a whole, split into segments or a window of it
+  using segments = std::vector<text::window>;
+
   struct source_matches {
+    std::filesystem::path const&                  source;
     std::filesystem::path const&                  rules_origin;
     std::shared_future<feedback::rules> const&    shared_rules;
-    std::shared_future<std::string> const&        shared_source;
+    std::function<segments const&()> const&       source_segments;
     std::shared_future<feedback::workflow> const& shared_workflow;
+    finding_budget&                               budget;
+    source_progress&                              progress;
+    rendered_feedback const&                      feedback_texts;
   };
 
   template <typename Interface> struct polymorphic_value {
@@ -161,7 +305,7 @@ namespace generator::output {
 
   */
 
-  void print(std::ostream& out, output::header) {
+  void print(io::chunk& out, output::header) {
     format::print(out,
                   R"_(// DO NOT EDIT: this file is generated automatically
 
@@ -175,22 +319,120 @@ namespace {{ using dummy = int; }}
 )_");
   }
 
-  void print(std::ostream& out, output::source source) {
+  void print(io::chunk& out, output::source source) {
     format::print(out, "\n#line 1 \"{}\"\n", source.filename.generic_u8string());
   }
 
+  struct suppressed {
+    std::filesystem::path const& rules_origin;
+    std::string_view             limit;
+  };
+
+  void print(io::chunk& out, output::suppressed suppressed) {
+    format::print(out,
+                  R"_(
+#line 1 "{origin}"
+#if defined __GNUC__
+# pragma message "note further findings suppressed after reaching {limit}"
+#elif defined _MSC_VER
+MESSAGE("note further findings suppressed after reaching {limit}")
+#endif
+)_",
+                  "origin"_a = suppressed.rules_origin.generic_u8string(), "limit"_a = suppressed.limit);
+  }
+
+  struct stopped {
+    std::filesystem::path const& rules_origin;
+    std::string_view             limit;
+  };
+
+  void print(io::chunk& out, output::stopped stopped) {
+    format::print(out,
+                  R"_(
+#line 1 "{origin}"
+#if defined __GNUC__
+# pragma message "note remaining sources and rules not scanned after reaching {limit}"
+#elif defined _MSC_VER
+MESSAGE("note remaining sources and rules not scanned after reaching {limit}")
+#endif
+)_",
+                  "origin"_a = stopped.rules_origin.generic_u8string(), "limit"_a = stopped.limit);
+  }
+
+  struct unscanned {
+    std::filesystem::path const& rules_origin;
+    std::size_t                  count;
+  };
+
+  void print(io::chunk& out, output::unscanned unscanned) {
+    format::print(out,
+                  R"_(
+#line 1 "{origin}"
+#if defined __GNUC__
+# pragma message "note {count} source(s) left unscanned after the time budget"
+#elif defined _MSC_VER
+MESSAGE("note {count} source(s) left unscanned after the time budget")
+#endif
+)_",
+                  "origin"_a = unscanned.rules_origin.generic_u8string(), "count"_a = unscanned.count);
+  }
+
+  void print_notes(io::chunk& out, std::filesystem::path const& rules_origin, output::stats const& stats) {
+    if (not stats.unscanned.empty())
+      print(out, unscanned{ rules_origin, stats.unscanned.size() });
+
+    if (not stats.suppressed_after.empty())
+      print(out, suppressed{ rules_origin, stats.suppressed_after });
+    else if (not stats.stopped_after.empty())
+      print(out, stopped{ rules_origin, stats.stopped_after });
+  }
+
+  // changed sources first, since their feedback matters most, then the remaining ones from small to large; the single
+  // reader queues them in this order, so the scanners start them in this order as well
+  auto prioritized(std::vector<std::filesystem::path> const& sources, scm::diff const& diff)
+  -> std::vector<std::filesystem::path> {
+    struct scheduled {
+      bool                         unchanged;
+      std::uintmax_t               size;
+      std::filesystem::path const* source;
+    };
+
+    auto schedule = std::vector<scheduled>{};
+    schedule.reserve(sources.size());
+
+    for (auto const& source : sources) {
+      auto error = std::error_code{};
+      auto size  = std::filesystem::file_size(source, error);
+
+      schedule.push_back({ diff.changes_from(source).empty(), error ? 0 : size, &source });
+    }
+
+    std::stable_sort(begin(schedule), end(schedule), [](auto const& lhs, auto const& rhs) {
+      return std::tie(lhs.unchanged, lhs.size) < std::tie(rhs.unchanged, rhs.size);
+    });
+
+    auto result = std::vector<std::filesystem::path>{};
+    result.reserve(schedule.size());
+
+    for (auto const& entry : schedule)
+      result.push_back(*entry.source);
+
+    return result;
+  }
+
   struct location {
     int line;
     int column;
   };
 
+  // the text of a finding is escaped already, its excerpt is not
   struct message {
     output::location const& location;
     std::string_view const& text;
     text::excerpt const&    highlighting;
   };
 
-  void print(std::ostream& out, output::message message) {
+  void print(io::chunk& out, output::message message) {
     format::print(out,
                   R"_(#if defined __GNUC__
 # line {line_before}
@@ -203,7 +445,7 @@ namespace {{ using dummy = int; }}
 )_",
                   "line_before"_a = message.location.line - 1, "line"_a = message.location.line,
                   "match"_a       = format::as_compiler_message{ message.highlighting.first_line },
-                  "text"_a        = format::as_compiler_message{ message.text },
+                  "text"_a        = message.text,
                   "indentation"_a = message.highlighting.indentation, "annotation"_a = message.highlighting.annotation);
   }
 
@@ -213,7 +455,7 @@ namespace {{ using dummy = int; }}
     text::excerpt const&    highlighting;
   };
 
-  void print(std::ostream& out, output::warning warning) {
+  void print(io::chunk& out, output::warning warning) {
     format::print(out,
                   R"_(#if defined __GNUC__
 # line {line_before}
@@ -226,7 +468,7 @@ namespace {{ using dummy = int; }}
 )_",
                   "line_before"_a = warning.location.line - 1, "line"_a = warning.location.line,
                   "match"_a       = format::as_compiler_message{ warning.highlighting.first_line },
-                  "text"_a        = format::as_compiler_message{ warning.text },
+                  "text"_a        = warning.text,
                   "indentation"_a = warning.highlighting.indentation, "annotation"_a = warning.highlighting.annotation);
   }
 
@@ -236,7 +478,7 @@ namespace {{ using dummy = int; }}
     text::excerpt const&    highlighting;
   };
 
-  void print(std::ostream& out, output::error error) {
+  void print(io::chunk& out, output::error error) {
     format::print(out,
                   R"_(#if defined __GNUC__
 # line {line_before}
@@ -249,101 +491,693 @@ namespace {{ using dummy = int; }}
 )_",
                   "line_before"_a = error.location.line - 1, "line"_a = error.location.line,
                   "match"_a       = format::as_compiler_message{ error.highlighting.first_line },
-                  "text"_a        = format::as_compiler_message{ error.text },
+                  "text"_a        = error.text,
                   "indentation"_a = error.highlighting.indentation, "annotation"_a = error.highlighting.annotation);
   }
 
-  template <class FUNCTION>
-  // emit (compiler, relevant_rule_in_source_matches)
+  struct capped {
+    output::location const& location;
+    std::string const&      text;
+  };
+
+  // the lines of the suppressed findings, e.g. "lines 12-40"
+  auto lines_of(suppressed_findings const& suppressed) {
+    return suppressed.first_line == suppressed.last_line
+           ? fmt::format("line {}", suppressed.first_line)
+           : fmt::format("lines {}-{}", suppressed.first_line, suppressed.last_line);
+  }
+
+  void print(io::chunk& out, output::capped capped) {
+    format::print(out,
+                  R"_(#if defined __GNUC__
+# line {line}
+# pragma message "note {text}"
+#elif defined _MSC_VER
+# line {line}
+MESSAGE("note {text}")
+#endif
+)_",
+                  "line"_a = capped.location.line, "text"_a = format::as_compiler_message{ capped.text });
+  }
+
+  // the length of the window text a rule searches: its own lines and as much of the overlap as a match may reach into
+  auto search_length(feedback::rule const& rule, text::window const& window) noexcept -> std::size_t {
+    auto const overlap = window.text.substr(window.own_length);
+    auto       reach   = std::size_t{ 0 };
+
+    auto const end_of_line = [&](std::size_t offset) {
+      auto const newline = overlap.find('\n', offset);
+      return newline == std::string_view::npos ? overlap.length() : newline + 1;
+    };
+
+    if (overlap.empty())
+      return window.text.length();
+
+    // the excerpt of a match needs the rest of its last line as well
+    if (rule.max_match_length > 0)
+      reach = end_of_line(std::min(rule.max_match_length - 1, overlap.length()));
+    else
+      for (auto lines = rule.max_match_lines; lines > 1 and reach < overlap.length(); --lines)
+        reach = end_of_line(reach);
 
-  auto print(std::ostream& out, rule_in_source_matches matches, FUNCTION relevant_rule_in_source_matches) {
+    return window.own_length + reach;
+  }
+
+  // a relevant match of a rule, found before it is admitted as finding
+  struct candidate {
+    int              line;
+    int              column;
+    std::string_view text;
+    std::string_view lines;
+  };
+
+  struct found_matches {
+    std::vector<candidate> candidates;
+    suppressed_findings    beyond; // the relevant matches after the candidates, only counted
+    std::size_t            resumed{ 0 }; // where the rule resumes in the next window
+    profile::rule_counters counters;
+  };
+
+  template <class FUNCTION>
+  auto find(rule_in_source_matches const& matches, text::window const& window, std::size_t resumed,
+            FUNCTION relevant_rule_in_source_matches) -> found_matches {
+    auto const  phase            = allocation::scope{ allocation::phase::scan };
     auto const& [id, attributes] = matches.rule;
+    auto const  source           = window.text.substr(0, search_length(attributes, window));
+
+    auto const start = profile::clock::now();
+    auto       found = found_matches{ {}, {}, 0, profile::rule_counters{ window.offset == 0 ? 1u : 0u, window.own_length } };
+
+    auto search = text::forward_search{ source, window.context, window.preceding_lines };
+    if (resumed > 0)
+      search.resume_at(resumed);
+
+    auto consumed = resumed;
+
+    // the source is lexed once on demand and only for rules with a narrower scope
+    auto const* mask        = attributes.scope == lexer::any ? nullptr : &matches.source_mask();
+    auto const  mask_offset = static_cast<std::size_t>(source.data() - window.context.data());
+
+    auto const& workflow = matches.shared_workflow.get();
+    auto const& response = workflow[attributes.type].response;
+
+    while (search.next(attributes.matched_text)) {
+      if (matches.budget.exhausted()) {
+        matches.budget.skip();
+        break;
+      }
+
+      auto const offset = static_cast<std::size_t>(search.matched_text().data() - source.data());
+
+      // a match starting in the overlap is found again in the next window
+      if (offset >= window.own_length)
+        break;
+
+      consumed = offset + search.matched_text().length();
+
+      if ((mask and not((*mask)[mask_offset + offset] & attributes.scope)) or
+          attributes.ignored_text.matches(search.matched_text())) {
+        ++found.counters.ignored_matches;
+        continue;
+      }
 
-    auto search = text::forward_search{ matches.shared_source.get() };
+      ++found.counters.matches;
 
-    while (search.next_but(attributes.matched_text, attributes.ignored_text)) {
       auto const line_number = search.line();
       if (not relevant_rule_in_source_matches(line_number))
         continue;
 
-      auto const feedback = fmt::format("{id}: {summary} [ {type} from file://{origin} ]\nrationale  : "
-                                        "{rationale}\nworkaround : {workaround}",
-                                        "id"_a = id, "type"_a = attributes.type, "summary"_a = attributes.summary,
-                                        "rationale"_a = attributes.rationale, "workaround"_a = attributes.workaround,
-                                        "origin"_a = matches.rules_origin.generic_u8string());
+      if (std::holds_alternative<feedback::none>(response))
+        continue;
+
+      // the matches after reaching the limits are only counted, without building their excerpts
+      if (found.candidates.size() < matches.max_candidates)
+        found.candidates.push_back({ line_number, search.column(), search.matched_text(), search.matched_lines() });
+      else
+        found.beyond.add(line_number);
+    }
+
+    found.resumed        = consumed > window.own_length ? consumed - window.own_length : 0;
+    found.counters.time = profile::clock::now() - start;
+    return found;
+  }
+
+  // the segments are scanned in parallel as if no match reached into them, a segment is scanned again after a match
+  // of the previous one did
+  template <class FUNCTION>
+  auto find(rule_in_source_matches const& matches, std::vector<text::window> const& segments, std::size_t resumed,
+            FUNCTION relevant_rule_in_source_matches) -> found_matches {
+    if (segments.size() == 1)
+      return find(matches, segments.front(), resumed, relevant_rule_in_source_matches);
+
+    auto found = std::vector<found_matches>(segments.size());
+    std::transform(std::execution::par, cbegin(segments), cend(segments), begin(found), [&](text::window const& segment) {
+      return find(matches, segment, 0, relevant_rule_in_source_matches);
+    });
+
+    auto stitched = found_matches{};
+    for (std::size_t index = 0; index < segments.size(); ++index) {
+      if (resumed > 0)
+        found[index] = find(matches, segments[index], resumed, relevant_rule_in_source_matches);
+
+      auto& segment_found = found[index];
+      stitched.candidates.insert(end(stitched.candidates), cbegin(segment_found.candidates), cend(segment_found.candidates));
+      stitched.beyond.merge(segment_found.beyond);
+      stitched.counters.files += segment_found.counters.files;
+      stitched.counters.bytes += segment_found.counters.bytes;
+      stitched.counters.matches += segment_found.counters.matches;
+      stitched.counters.ignored_matches += segment_found.counters.ignored_matches;
+      stitched.counters.time += segment_found.counters.time;
+
+      resumed = segment_found.resumed;
+    }
+
+    stitched.resumed = resumed;
+    return stitched;
+  }
+
+  // the limit of findings of a rule in a source, 0 if there is none
+  auto max_findings_per_rule(feedback::rule const& rule, output::options const& options) noexcept {
+    return rule.max_findings_per_file > 0 ? rule.max_findings_per_file : options.max_findings_per_rule;
+  }
+
+  // the number of candidates which reaches the limits of a rule in a source, if the limits still apply after a baseline;
+  // further matches are only counted
+  auto max_candidates(feedback::rule const& rule, output::options const& options, rule_progress const& progress,
+                      source_progress const& source) noexcept {
+    auto       limit      = std::numeric_limits<std::size_t>::max();
+    auto const rule_limit = max_findings_per_rule(rule, options);
+    auto const file_limit = options.max_findings_per_file;
+
+    if (options.known_findings)
+      return limit;
+
+    if (rule_limit > 0)
+      limit = std::min(limit, rule_limit - std::min(rule_limit, progress.emitted));
+
+    if (file_limit > 0)
+      limit = std::min(limit, file_limit - std::min(file_limit, source.emitted.load()));
+
+    return limit;
+  }
+
+  // admits a finding within the limits of its rule and its source, otherwise marks which of them capped it
+  auto admit(rule_in_source_matches const& matches) -> bool {
+    auto const rule_limit = max_findings_per_rule(matches.rule.second, matches.options);
+    auto const file_limit = matches.options.max_findings_per_file;
+
+    if (rule_limit > 0 and matches.progress.emitted >= rule_limit) {
+      matches.progress.capped = true;
+      return false;
+    }
+
+    if (matches.in_source.capped)
+      return false;
+
+    if (file_limit > 0 and matches.in_source.emitted.fetch_add(1) >= file_limit) {
+      matches.in_source.capped = true;
+      return false;
+    }
+
+    return true;
+  }
+
+  // counts findings after a cap for the note of the rule, or for the one of the source if its limit capped them
+  void suppress(rule_in_source_matches const& matches, suppressed_findings const& suppressed) {
+    if (suppressed.count == 0)
+      return;
+
+    auto const rule_limit = max_findings_per_rule(matches.rule.second, matches.options);
+
+    if (rule_limit > 0 and matches.progress.emitted >= rule_limit) {
+      matches.progress.capped = true;
+      matches.progress.suppressed.merge(suppressed);
+      return;
+    }
+
+    auto const locked = std::lock_guard(matches.in_source.suppressed_lock);
+    matches.in_source.capped = true;
+    matches.in_source.suppressed.merge(suppressed);
+  }
+
+  // the single note of a rule capped in a source, after all of its windows
+  void print_suppressed(io::chunk& out, feedback::rules::value_type const& rule, rule_progress const& progress,
+                        output::options const& options) {
+    auto const& suppressed = progress.suppressed;
+    if (suppressed.count == 0)
+      return;
+
+    print(out, capped{ output::location{ suppressed.first_line, 1 },
+                       fmt::format("{}: and {} more finding(s) in {}, suppressed after {} in this source", rule.first,
+                                   suppressed.count, lines_of(suppressed), max_findings_per_rule(rule.second, options)) });
+  }
+
+  // the single note of a source capped by --max-findings-per-file, after all of its rules and windows
+  void print_suppressed(io::chunk& out, source_progress const& progress, output::options const& options) {
+    auto const& suppressed = progress.suppressed;
+    if (suppressed.count == 0)
+      return;
+
+    print(out, capped{ output::location{ suppressed.first_line, 1 },
+                       fmt::format("and {} more finding(s) in {}, suppressed after reaching --max-findings-per-file={}",
+                                   suppressed.count, lines_of(suppressed), options.max_findings_per_file) });
+  }
+
+  // gives back the place of an admitted finding in its source, which the budget of the run rejected afterwards
+  void withdraw(rule_in_source_matches const& matches) {
+    if (matches.options.max_findings_per_file > 0)
+      matches.in_source.emitted.fetch_sub(1);
+  }
+
+  // emit (compiler, relevant_rule_in_source_matches)
+  auto emit(io::chunk& out, rule_in_source_matches const& matches, found_matches const& found) -> profile::duration {
+    auto const  phase            = allocation::scope{ allocation::phase::emit };
+    auto const  start            = profile::clock::now();
+    auto const& [id, attributes] = matches.rule;
+
+    auto const& workflow = matches.shared_workflow.get();
+    auto const& response = workflow[attributes.type].response;
+    auto const& feedback = matches.feedback;
+
+    // emitting runs no nested parallel algorithm, so no other task on this worker can use its arena meanwhile
+    thread_local auto arena_buffer = std::array<std::byte, 16 << 10>{};
+    auto              arena        = std::pmr::monotonic_buffer_resource{ arena_buffer.data(), arena_buffer.size() };
+
+    for (auto const& candidate : found.candidates) {
+      if (matches.options.known_findings or matches.options.recorded_findings) {
+        auto const finding = baseline::fingerprint{ id, matches.fingerprint_file, baseline::content_hash(candidate.lines) };
+
+        if (matches.options.recorded_findings)
+          matches.options.recorded_findings->add(finding);
+
+        if (matches.options.known_findings and matches.options.known_findings->consume(finding))
+          continue;
+      }
+
+      if (not admit(matches)) {
+        auto suppressed = suppressed_findings{};
+        suppressed.add(candidate.line);
+        suppress(matches, suppressed);
+        continue;
+      }
+
+      if (not matches.budget.admit(std::holds_alternative<feedback::error>(response))) {
+        withdraw(matches);
+        return profile::clock::now() - start;
+      }
+
+      ++matches.progress.emitted;
+
+      // the excerpt of a finding is dropped after printing it, so all of them share the first block of the arena
+      arena.release();
+
+      auto const location     = output::location{ candidate.line, candidate.column };
+      auto const highlighting = text::highlight(candidate.lines, candidate.text, attributes.marked_text, &arena);
 
       // compiler.emit_feedback (response, ...)
 
-      auto const& workflow = matches.shared_workflow.get();
       std::visit(overloaded{ [&](feedback::none) {},
-                             [&](feedback::message) {
-                               print(out, output::message{ location{ line_number, search.column() }, feedback,
-                                                           search.highlighted_text(attributes.marked_text) });
-                             },
-                             [&](feedback::warning) {
-                               print(out, output::warning{ location{ line_number, search.column() }, feedback,
-                                                           search.highlighted_text(attributes.marked_text) });
-                             },
-                             [&](feedback::error) {
-                               print(out, output::error{ location{ line_number, search.column() }, feedback,
-                                                         search.highlighted_text(attributes.marked_text) });
-                             } },
-                 workflow[attributes.type].response);
+                             [&](feedback::message) { print(out, output::message{ location, feedback, highlighting }); },
+                             [&](feedback::warning) { print(out, output::warning{ location, feedback, highlighting }); },
+                             [&](feedback::error) { print(out, output::error{ location, feedback, highlighting }); } },
+                 response);
     }
+
+    suppress(matches, found.beyond);
+
+    return profile::clock::now() - start;
   }
 
   template <class FUNCTION>
   // emit (compiler, relevant_source_matches)
-  auto print(std::ostream& out, source_matches matches, FUNCTION relevant_source_matches, stats merged_stats = {}) {
-    auto const& rules = matches.shared_rules.get();
+  auto print(io::chunk& out, source_matches matches, FUNCTION relevant_source_matches, output::options options) -> bool {
+    auto const  traced = trace::span{ options.tracer, "scan", matches.source };
+    auto const& rules  = matches.shared_rules.get();
 
     std::atomic_bool any_rule_relevant{ false };
+    std::mutex       out_lock;
+    std::mutex       timings_lock;
+    auto             timings = profile::file_timings{};
+
+    // relative paths keep fingerprints stable across checkouts in different directories
+    auto const fingerprint_file =
+    options.known_findings or options.recorded_findings
+    ? std::filesystem::absolute(matches.source).lexically_normal().lexically_proximate(std::filesystem::current_path()).generic_u8string()
+    : std::string{};
+
+    std::once_flag             lexed;
+    std::optional<lexer::mask> mask;
+
+    auto const source_mask = std::function<lexer::mask const&()>{ [&]() -> lexer::mask const& {
+      std::call_once(lexed, [&] { mask.emplace(matches.source_segments().front().context); });
+      return *mask;
+    } };
+
+    // the rules of a source run in parallel, so the wall time of the source is measured around all of them
+    auto const scan_start = profile::clock::now();
+
+    std::for_each(std::execution::par, cbegin(rules), cend(rules), [=, &out, &any_rule_relevant, &out_lock, &timings_lock, &timings, &source_mask, &fingerprint_file](auto const& rule) {
+      if (matches.budget.exhausted()) {
+        matches.budget.skip();
+        return;
+      }
 
-    std::for_each(std::execution::par, cbegin(rules), cend(rules), [=, &out, &any_rule_relevant](auto const& rule) {
       auto const relevant_rule_in_source_matches = relevant_source_matches(rule);
       if (not relevant_rule_in_source_matches())
         return;
 
       any_rule_relevant = true;
 
-      // compiler.share ()
-      auto synchronized_out = cxx20::osyncstream{ out };
+      auto const traced = trace::span{ options.tracer, "rule", rule.first };
+
+      auto  whole    = rule_progress{};
+      auto& progress = matches.progress.rules.empty() ? whole : matches.progress.rules.at(rule.first);
+
+      auto const rule_matches = rule_in_source_matches{ matches.rules_origin, rule, matches.shared_workflow, matches.budget, source_mask, options, fingerprint_file,
+                                                        progress, matches.progress, max_candidates(rule.second, options, progress, matches.progress),
+                                                        matches.feedback_texts.at(&rule.second) };
+
+      auto found = find(rule_matches, matches.source_segments(), progress.resumed, relevant_rule_in_source_matches);
+
+      progress.resumed = found.resumed;
+
+      // the time of a rule in a source is the time to find its matches and then to emit them
+      auto const scan_time = found.counters.time;
+      auto       emit_time = profile::duration{ 0 };
+
+      {
+        // each worker formats into its own chunk, which keeps its capacity for the following rules; it is used only
+        // after finding the matches, since a worker may run other rules while it waits for the segments of this one
+        thread_local auto rule_out = io::chunk{};
+        rule_out.clear();
+
+        emit_time = emit(rule_out, rule_matches, found);
+
+        // the note of a source scanned in windows follows its last window
+        if (matches.progress.rules.empty())
+          print_suppressed(rule_out, rule, progress, options);
+
+        if (rule_out.size() > 0) {
+          auto const emit_phase = allocation::scope{ allocation::phase::emit };
+          auto const emit_start = profile::clock::now();
+          auto const locked     = std::lock_guard(out_lock);
+
+          out.append(rule_out.data(), rule_out.data() + rule_out.size());
+          emit_time += profile::clock::now() - emit_start;
+        }
+      }
 
-      print(synchronized_out, rule_in_source_matches{ matches.rules_origin, rule, matches.shared_source, matches.shared_workflow },
-            relevant_rule_in_source_matches);
+      if (not options.profiler)
+        return;
+
+      auto counters = found.counters;
+      counters.time = scan_time + emit_time;
+      options.profiler->record(rule.first, matches.source, counters);
+
+      auto const locked = std::lock_guard(timings_lock);
+      timings.rule_scan += scan_time;
+      timings.rule_emit += emit_time;
     });
 
-    if (any_rule_relevant)
-      merged_stats.process(matches.shared_source.get());
+    if (options.profiler) {
+      timings.scan = profile::clock::now() - scan_start;
+      options.profiler->record(matches.source, timings);
+    }
 
-    return merged_stats;
+    if (matches.progress.rules.empty())
+      print_suppressed(out, matches.progress, options);
+
+    return any_rule_relevant.load();
+  }
+
+  // scans a source window by window, so that only the current window is held in memory
+  template <class FUNCTION>
+  auto print_windows(io::chunk& out, source_matches matches, FUNCTION relevant_source_matches, output::options options)
+  -> stats {
+    auto reader   = io::window_reader{ matches.source, options.window_size };
+    auto relevant = false;
+    auto bytes    = std::size_t{ 0 };
+
+    for (auto const& rule : matches.shared_rules.get())
+      matches.progress.rules.emplace(rule.first, rule_progress{});
+
+    while (true) {
+      auto window = std::optional<text::window>{};
+
+      {
+        auto const read  = trace::span{ options.tracer, "read", matches.source };
+        auto const phase = allocation::scope{ allocation::phase::read };
+        auto const start = profile::clock::now();
+
+        window = reader.next();
+
+        if (options.profiler)
+          options.profiler->record(matches.source, profile::file_timings{ profile::clock::now() - start });
+      }
+
+      if (not window)
+        break;
+
+      if (matches.budget.exhausted()) {
+        matches.budget.skip();
+        break;
+      }
+
+      auto const current         = segments{ *window };
+      auto const source_segments = std::function<segments const&()>{ [&]() -> segments const& { return current; } };
+
+      relevant |= print(out, source_matches{ matches.source, matches.rules_origin, matches.shared_rules, source_segments, matches.shared_workflow, matches.budget, matches.progress, matches.feedback_texts },
+                        relevant_source_matches, options);
+      bytes += window->own_length;
+    }
+
+    // the rules are unordered, their notes are not
+    auto const& rules = matches.shared_rules.get();
+    auto        ids   = std::vector<std::string>{};
+    for (auto const& [id, progress] : matches.progress.rules)
+      ids.push_back(id);
+
+    std::sort(begin(ids), end(ids));
+    for (auto const& id : ids)
+      print_suppressed(out, *rules.find(id), matches.progress.rules.at(id), options);
+
+    print_suppressed(out, matches.progress, options);
+
+    auto source_stats = stats{};
+    if (relevant)
+      source_stats.process(bytes);
+
+    return source_stats;
   }
 
+  // a source on its way from the reader to the scanners
+  struct read_source {
+    std::filesystem::path      source;
+    std::optional<std::string> content; // none if the source is scanned window by window
+  };
+
   // emit (compiler, matches)
-  auto print(std::ostream& out, output::matches matches, stats merged_stats) -> stats {
+  auto print(std::ostream& out, output::matches matches, output::options options, stats merged_stats) -> stats {
+    // each window is lexed on its own, which would start it in code even inside a comment or a raw string
+    if (options.window_size > 0)
+      for (auto const& [id, attributes] : matches.shared_rules.get())
+        if (attributes.scope != lexer::any)
+          throw std::invalid_argument{ "rule " + id + " has a scope, which cannot be scanned with --window-size" };
+
+    auto const scanners = options.scanners > 0 ? options.scanners : std::max(std::thread::hardware_concurrency(), 1u);
+    auto const capacity = [&](std::size_t configured) { return configured > 0 ? configured : 2 * scanners; };
+
     std::mutex lock;
+    auto       writer = io::chunk_writer{ out, capacity(options.pending_sections) };
 
-    // compiler.emit_header (header{})
-    print(out, header{ matches.rules_origin, matches.shared_rules, matches.shared_workflow });
+    {
+      auto const traced = trace::span{ options.tracer, "header" };
+      auto const phase  = allocation::scope{ allocation::phase::emit };
+      auto       chunk  = writer.acquire();
 
-    auto const  relevant_matches = make_relevant_matches(matches.shared_workflow, matches.shared_diff);
-    auto const& sources          = matches.shared_sources.get();
+      // compiler.emit_header (header{})
+      print(chunk, header{ matches.rules_origin, matches.shared_rules, matches.shared_workflow });
+      writer.submit(std::move(chunk));
+    }
 
-    std::for_each(std::execution::par, cbegin(sources), cend(sources), [=, &out, &merged_stats, &lock](std::filesystem::path const& source) {
-      auto const shared_source = std::async(std::launch::async, [=] { return io::content(source); }).share();
+    auto const  relevant_matches = make_relevant_matches(matches.shared_workflow, matches.shared_diff,
+                                                                 options.known_findings or options.recorded_findings);
+    auto const  scheduled        = options.deadline ? prioritized(matches.shared_sources.get(), matches.shared_diff.get())
+                                                    : std::vector<std::filesystem::path>{};
+    auto const& sources          = options.deadline ? scheduled : matches.shared_sources.get();
 
-      // auto local_compiler = compiler.share ().source_scope (source)
-      auto synchronized_out = cxx20::osyncstream{ out };
+    auto       budget         = finding_budget{ options };
+    auto const feedback_texts = render(matches.shared_rules.get(), matches.rules_origin);
+    auto       read_queue     = container::bounded_queue<read_source>{ capacity(options.read_ahead) };
+    auto       failure        = std::exception_ptr{};
+    auto       failed         = std::atomic_bool{ false };
 
-      print(synchronized_out, output::source{ source });
-      auto const source_stats =
-      print(synchronized_out, source_matches{ matches.rules_origin, matches.shared_rules, shared_source, matches.shared_workflow },
-            relevant_matches(source));
+    auto const deadline_passed = [&] {
+      return options.deadline and profile::clock::now() >= *options.deadline;
+    };
 
+    auto const leave_unscanned = [&](std::filesystem::path const& source) {
       auto const locked = std::lock_guard(lock);
-      merged_stats.merge(source_stats);
-    });
+      merged_stats.unscanned.push_back(source);
+    };
+
+    // the reader stays ahead of the scanners by the capacity of the queue, so reading overlaps scanning while the
+    // memory of the sources read but not yet scanned remains bounded
+    auto const reader = [&] {
+      for (auto const& source : sources) {
+        if (failed)
+          break;
+
+        if (budget.exhausted()) {
+          budget.skip();
+          break;
+        }
+
+        if (deadline_passed()) {
+          leave_unscanned(source);
+          continue;
+        }
+
+        auto error = std::error_code{};
+        auto size  = std::filesystem::file_size(source, error);
+        auto read  = read_source{ source, std::nullopt };
+
+        if (options.window_size == 0 or size <= options.window_size or error) {
+          auto const traced = trace::span{ options.tracer, "read", source };
+          auto const phase  = allocation::scope{ allocation::phase::read };
+          auto const start  = profile::clock::now();
+
+          read.content = io::content(source);
+
+          if (options.profiler)
+            options.profiler->record(source, profile::file_timings{ profile::clock::now() - start });
+        }
+
+        if (not read_queue.push(std::move(read)))
+          break;
+      }
+
+      read_queue.close();
+    };
+
+    // each scanner scans one source at a time with all of its rules in parallel, the writer blocks it while the
+    // capacity of sections waiting to be written is exhausted
+    auto const scanner = [&] {
+      while (auto read = read_queue.pop()) {
+        auto const& source = read->source;
+
+        if (failed)
+          break;
+
+        if (budget.exhausted()) {
+          budget.skip();
+          continue;
+        }
+
+        if (deadline_passed()) {
+          leave_unscanned(source);
+          continue;
+        }
 
+        auto const traced = trace::span{ options.tracer, "source", source };
+
+        // auto local_compiler = compiler.share ().source_scope (source)
+        auto chunk = writer.acquire();
+
+        print(chunk, output::source{ source });
+
+        auto progress     = source_progress{};
+        auto source_stats = stats{};
+
+        if (not read->content) {
+          auto const no_segments = std::function<segments const&()>{};
+          source_stats = print_windows(chunk, source_matches{ source, matches.rules_origin, matches.shared_rules, no_segments, matches.shared_workflow, budget, progress, feedback_texts },
+                                       relevant_matches(source), options);
+        }
+        else {
+          auto const& content = *read->content;
+
+          // a large source is split here, since its segments are counted in parallel
+          auto const split           = options.segment_size > 0 and content.length() > options.segment_size;
+          auto const source_windows  = split ? text::split(content, options.segment_size) : segments{ text::window::whole(content) };
+          auto const source_segments = std::function<segments const&()>{ [&]() -> segments const& { return source_windows; } };
+
+          if (print(chunk, source_matches{ source, matches.rules_origin, matches.shared_rules, source_segments, matches.shared_workflow, budget, progress, feedback_texts },
+                    relevant_matches(source), options))
+            source_stats.process(content);
+        }
+
+        writer.submit(std::move(chunk));
+
+        auto const locked = std::lock_guard(lock);
+        merged_stats.merge(source_stats);
+      }
+    };
+
+    // the first failure of a stage stops the others and is rethrown after all of them stopped
+    auto const stopping_on_failure = [&](auto const& stage) {
+      return [&] {
+        try {
+          stage();
+        }
+        catch (...) {
+          {
+            auto const locked = std::lock_guard(lock);
+            if (not failure)
+              failure = std::current_exception();
+          }
+
+          failed = true;
+          read_queue.close();
+        }
+      };
+    };
+
+    {
+      auto reading  = std::thread{ stopping_on_failure(reader) };
+      auto scanning = std::vector<std::thread>{};
+
+      for (std::size_t index = 0; index < scanners; ++index)
+        scanning.emplace_back(stopping_on_failure(scanner));
+
+      reading.join();
+      for (auto& scanned : scanning)
+        scanned.join();
+    }
+
+    if (failure)
+      std::rethrow_exception(failure);
+
+    merged_stats.read_queue.merge(read_queue.counters());
+
+    std::sort(begin(merged_stats.unscanned), end(merged_stats.unscanned));
+
+    if (budget.exhausted()) {
+      auto const option = budget.reached();
+      auto const limit  = option == "--max-errors" ? options.max_errors : options.max_findings;
+
+      if (budget.suppressed())
+        merged_stats.suppressed_after = fmt::format("{}={}", option, limit);
+      else if (budget.skipped())
+        merged_stats.stopped_after = fmt::format("{}={}", option, limit);
+    }
+
+    {
+      auto chunk = writer.acquire();
+      print_notes(chunk, matches.rules_origin, merged_stats);
+      writer.submit(std::move(chunk));
+    }
+
+    writer.flush();
+
+    merged_stats.section_queue.merge(writer.counters());
     return merged_stats;
   }
+
+  auto notes(std::filesystem::path const& rules_origin, output::stats const& stats) -> std::string {
+    auto out = io::chunk{};
+    print_notes(out, rules_origin, stats);
+
+    return std::string{ out.data(), out.size() };
+  }
 } // namespace generator::output
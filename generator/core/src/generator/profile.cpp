@@ -0,0 +1,95 @@
+#include "generator/profile.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace generator::profile {
+
+  namespace {
+    auto milliseconds(duration time) {
+      return std::chrono::duration<double, std::milli>{ time }.count();
+    }
+
+    auto slower(duration lhs, duration rhs) {
+      return lhs > rhs;
+    }
+  } // namespace
+
+  recorder::recorder(std::size_t top_count) : top_count_(top_count) {
+  }
+
+  void recorder::record(std::string const& rule, std::filesystem::path const& source, rule_counters const& counters) {
+    auto const locked = std::lock_guard{ mutex_ };
+
+    auto& total = rules_[rule];
+    total.files += counters.files;
+    total.bytes += counters.bytes;
+    total.matches += counters.matches;
+    total.ignored_matches += counters.ignored_matches;
+    total.time += counters.time;
+
+    if (top_count_ == 0)
+      return;
+
+    // min heap of the slowest pairs, its front is the fastest of them
+    auto const faster = [](auto const& lhs, auto const& rhs) { return slower(lhs.time, rhs.time); };
+
+    if (slowest_.size() == top_count_) {
+      if (not slower(counters.time, slowest_.front().time))
+        return;
+
+      std::pop_heap(begin(slowest_), end(slowest_), faster);
+      slowest_.pop_back();
+    }
+
+    slowest_.push_back({ counters.time, rule, source });
+    std::push_heap(begin(slowest_), end(slowest_), faster);
+  }
+
+  void recorder::record(std::filesystem::path const& source, file_timings const& timings) {
+    auto const locked = std::lock_guard{ mutex_ };
+
+    auto& total = files_[source];
+    total.read += timings.read;
+    total.scan += timings.scan;
+    total.rule_scan += timings.rule_scan;
+    total.rule_emit += timings.rule_emit;
+  }
+
+  auto recorder::to_json() const -> std::string {
+    auto const locked = std::lock_guard{ mutex_ };
+
+    auto rules = nlohmann::json::object();
+    for (auto const& [id, counters] : std::map<std::string, rule_counters>{ begin(rules_), end(rules_) })
+      rules[id] = { { "files", counters.files },
+                    { "bytes", counters.bytes },
+                    { "matches", counters.matches },
+                    { "ignored_matches", counters.ignored_matches },
+                    { "milliseconds", milliseconds(counters.time) } };
+
+    auto files = nlohmann::json::array();
+    for (auto const& [source, timings] : files_)
+      files.push_back({ { "source", source.generic_u8string() },
+                        { "read_milliseconds", milliseconds(timings.read) },
+                        { "scan_milliseconds", milliseconds(timings.scan) },
+                        { "rule_scan_milliseconds", milliseconds(timings.rule_scan) },
+                        { "rule_emit_milliseconds", milliseconds(timings.rule_emit) } });
+
+    std::sort(begin(files), end(files), [](auto const& lhs, auto const& rhs) { return lhs["source"] < rhs["source"]; });
+
+    auto sorted_slowest = slowest_;
+    std::sort(begin(sorted_slowest), end(sorted_slowest), [](auto const& lhs, auto const& rhs) {
+      return slower(lhs.time, rhs.time);
+    });
+
+    auto slowest = nlohmann::json::array();
+    for (auto const& pair : sorted_slowest)
+      slowest.push_back({ { "rule", pair.rule },
+                          { "source", pair.source.generic_u8string() },
+                          { "milliseconds", milliseconds(pair.time) } });
+
+    return nlohmann::json{ { "rules", rules }, { "files", files }, { "slowest", slowest } }.dump(2);
+  }
+} // namespace generator::profile
@@ -1,11 +1,17 @@
 #include "generator/regex.h"
 
+#include "generator/kernel.h"
+
+#include <re2/filtered_re2.h>
 #include <re2/re2.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace generator::regex {
   namespace {
@@ -16,6 +22,108 @@ namespace generator::regex {
     auto as_string_view(re2::StringPiece const& match) {
       return std::string_view{ match.data(), match.length() };
     }
+
+    // the position after a character class starting at position
+    auto skip_class(std::string_view pattern, std::size_t position) -> std::size_t {
+      ++position;
+      if (pattern.substr(position, 1) == "^")
+        ++position;
+
+      // a leading ] is a literal
+      if (pattern.substr(position, 1) == "]")
+        ++position;
+
+      while (position < pattern.length() and pattern[position] != ']') {
+        if (pattern[position] == '\\')
+          position += 2;
+        else if (pattern.substr(position, 2) == "[:")
+          position = std::min(pattern.find(":]", position + 2), pattern.length()) + 2;
+        else
+          ++position;
+      }
+
+      return std::min(position + 1, pattern.length());
+    }
+
+    // the position of the | ending an alternative or of the ) closing its group, the end of the pattern otherwise
+    auto skip_alternative(std::string_view pattern, std::size_t position) -> std::size_t {
+      auto depth = 0;
+
+      while (position < pattern.length()) {
+        auto const character = pattern[position];
+
+        if (character == '\\')
+          position += 2;
+        else if (character == '[')
+          position = skip_class(pattern, position);
+        else if ((character == '|' or character == ')') and depth == 0)
+          return position;
+        else {
+          depth += character == '(' ? 1 : character == ')' ? -1 : 0;
+          ++position;
+        }
+      }
+
+      return pattern.length();
+    }
+
+    auto anchored_alternatives(std::string_view pattern, std::size_t& position) -> bool;
+
+    // whether an alternative starts with ^ or \A, possibly inside groups or after flags like (?i)
+    auto anchored_alternative(std::string_view pattern, std::size_t& position) -> bool {
+      while (position < pattern.length()) {
+        auto const rest = pattern.substr(position);
+
+        if (rest.substr(0, 1) == "^" or rest.substr(0, 2) == "\\A")
+          return true;
+
+        if (rest.substr(0, 1) != "(")
+          return false;
+
+        auto const flags = rest.substr(0, 2) == "(?" and rest.substr(2, 1) != "P";
+        auto const end   = rest.find_first_of(":)");
+
+        // flags without a group match nothing and apply to the rest of the alternative
+        if (flags and rest[end] == ')') {
+          position += end + 1;
+          continue;
+        }
+
+        // the group starts after its flags or its name, if any
+        position += not flags and rest.substr(0, 2) == "(?" ? rest.find('>') + 1 : flags ? end + 1 : 1;
+
+        auto const anchored = anchored_alternatives(pattern, position);
+        position            = std::min(position + 1, pattern.length());
+
+        // a group which may be skipped anchors nothing
+        auto const quantifier = pattern.substr(position, 2);
+        return anchored and quantifier.substr(0, 1) != "?" and quantifier.substr(0, 1) != "*" and quantifier != "{0";
+      }
+
+      return false;
+    }
+
+    // whether all alternatives up to the end of the pattern or of the current group are anchored; the position is
+    // left at the end or at the ) closing the group
+    auto anchored_alternatives(std::string_view pattern, std::size_t& position) -> bool {
+      auto anchored = true;
+
+      while (true) {
+        anchored = anchored_alternative(pattern, position) and anchored;
+        position = skip_alternative(pattern, position);
+
+        if (position >= pattern.length() or pattern[position] == ')')
+          return anchored;
+
+        ++position;
+      }
+    }
+
+    // the pattern was parsed by RE2 already, so its groups and classes are balanced
+    auto anchored(std::string_view pattern) -> bool {
+      auto position = std::size_t{ 0 };
+      return anchored_alternatives(pattern, position);
+    }
   } // namespace
 
   class precompiled::impl : public re2::RE2 {
@@ -42,11 +150,23 @@ namespace generator::regex {
   }
 
   auto precompiled::matches(std::string_view input, std::initializer_list<match*> captures_ret) const -> bool {
+    if (kernel) {
+      auto found = regex::match{};
+      if (not find_builtin(input, input, &found, nullptr, nullptr))
+        return false;
+
+      // a kernel has a single capture, its match
+      if (captures_ret.size() > 0 and *captures_ret.begin())
+        **captures_ret.begin() = found;
+
+      return true;
+    }
+
     auto constexpr max_captures = 64;
 
     std::array<re2::StringPiece, max_captures> re2_captures;
     std::array<re2::RE2::Arg, max_captures>    re2_args;
-    std::array<re2::RE2::Arg*, max_captures>   re2_args_p;
+    std::array<re2::RE2::Arg*, max_captures>   re2_args_p{};
 
     if (captures_ret.size() > re2_captures.size())
       return false;
@@ -65,6 +185,9 @@ namespace generator::regex {
   }
 
   auto precompiled::find(std::string_view input, match* match_ret, match* skipped_ret, match* remaining_ret) const -> bool {
+    if (kernel)
+      return find_builtin(input, input, match_ret, skipped_ret, remaining_ret);
+
     auto remaining = as_string_piece(input);
     auto match     = re2::StringPiece{};
 
@@ -86,6 +209,89 @@ namespace generator::regex {
     return true;
   }
 
+  auto precompiled::find(std::string_view input, std::string_view context, match* match_ret, match* skipped_ret,
+                         match* remaining_ret) const -> bool {
+    if (input.data() == context.data() and input.length() == context.length())
+      return find(input, match_ret, skipped_ret, remaining_ret);
+
+    if (kernel)
+      return find_builtin(input, context, match_ret, skipped_ret, remaining_ret);
+
+    assert(context.data() <= input.data());
+    assert(context.data() + context.length() >= input.data() + input.length());
+
+    // like FindAndConsume: the first capture is returned, the whole match is consumed
+    std::array<re2::StringPiece, 2> submatches;
+    if (engine->NumberOfCapturingGroups() < 1)
+      return false;
+
+    auto const start = static_cast<std::size_t>(input.data() - context.data());
+    if (not engine->Match(as_string_piece(context), start, start + input.length(), RE2::UNANCHORED, submatches.data(),
+                          static_cast<int>(submatches.size())))
+      return false;
+
+    auto const consumed = static_cast<std::size_t>(submatches[0].data() + submatches[0].length() - input.data());
+    auto const captured = submatches[1].data() ? as_string_view(submatches[1]) : input.substr(consumed, 0);
+
+    if (match_ret)
+      *match_ret = captured;
+
+    if (skipped_ret)
+      *skipped_ret = input.substr(0, static_cast<std::size_t>(captured.data() - input.data()));
+
+    if (remaining_ret)
+      *remaining_ret = input.substr(consumed);
+
+    return true;
+  }
+
+  auto precompiled::find_builtin(std::string_view input, std::string_view context, match* match_ret, match* skipped_ret,
+                                 match* remaining_ret) const -> bool {
+    auto const found = kernel->find(input, context);
+    if (not found)
+      return false;
+
+    auto const skipped = static_cast<std::size_t>(found->data() - input.data());
+
+    if (match_ret)
+      *match_ret = *found;
+
+    if (skipped_ret)
+      *skipped_ret = input.substr(0, skipped);
+
+    if (remaining_ret)
+      *remaining_ret = input.substr(skipped + found->length());
+
+    return true;
+  }
+
+  auto precompiled::cost(std::int64_t memory_budget) const -> regex::cost {
+    // a kernel has no program and needs no memory
+    if (kernel)
+      return { 0, false, false, true };
+
+    if (not engine)
+      return {};
+
+    auto constexpr min_atom_length = 3;
+
+    // a pattern without atoms can't be prefiltered by a required literal
+    auto filter = re2::FilteredRE2{ min_atom_length };
+    auto id     = 0;
+    auto atoms  = std::vector<std::string>{};
+
+    if (filter.Add(engine->pattern(), engine->options(), &id) == RE2::NoError)
+      filter.Compile(&atoms);
+
+    auto options = engine->options();
+    options.set_max_mem(memory_budget);
+    options.set_log_errors(false);
+
+    auto const budgeted = RE2{ engine->pattern(), options };
+
+    return { engine->ProgramSize(), not atoms.empty(), anchored(engine->pattern()), budgeted.ok() };
+  }
+
   auto compile(std::string_view pattern) -> precompiled {
     return precompiled{ pattern };
   }
@@ -93,4 +299,10 @@ namespace generator::regex {
   auto capture(std::string_view pattern) -> precompiled {
     return compile(std::string{ "(" }.append(pattern).append(")"));
   }
+
+  auto builtin(std::string_view name) -> precompiled {
+    auto result   = precompiled{};
+    result.kernel = std::make_shared<kernel::builtin const>(name);
+    return result;
+  }
 } // namespace generator::regex
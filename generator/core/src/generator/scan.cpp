@@ -0,0 +1,79 @@
+#include "generator/scan.h"
+
+#include "generator/lexer.h"
+#include "generator/text.h"
+
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <optional>
+#include <tuple>
+
+namespace generator::scan {
+
+  auto find(feedback::rules const& rules, feedback::workflow const& workflow, buffer const& source) -> std::vector<finding> {
+    auto const name    = source.path.generic_u8string();
+    auto const changes = source.changes ? *source.changes : scm::diff::changes::all_lines();
+
+    auto found = std::vector<finding>{};
+    auto mask  = std::optional<lexer::mask>{};
+
+    for (auto const& [id, rule] : rules) {
+      if (not rule.matched_files.matches(name) or rule.ignored_files.matches(name))
+        continue;
+
+      auto const handling = workflow[rule.type];
+      auto const relevant = feedback::relevance_of(handling, not changes.empty());
+
+      if (not relevant.source)
+        continue;
+
+      // the source is lexed once on demand and only for rules with a narrower scope
+      if (rule.scope != lexer::any and not mask)
+        mask.emplace(source.content);
+
+      auto search = text::forward_search{ source.content };
+      while (search.next(rule.matched_text)) {
+        auto const offset = static_cast<std::size_t>(search.matched_text().data() - source.content.data());
+
+        if ((rule.scope != lexer::any and not((*mask)[offset] & rule.scope)) or
+            rule.ignored_text.matches(search.matched_text()))
+          continue;
+
+        auto const line = search.line();
+        if (not relevant.all_lines and not changes[line])
+          continue;
+
+        found.push_back({ id, handling.response, source.path, line, search.column(), std::string{ search.matched_text() },
+                          std::string{ search.matched_lines() } });
+      }
+    }
+
+    // the rules are unordered, the findings are not
+    std::sort(begin(found), end(found), [](finding const& lhs, finding const& rhs) {
+      return std::tie(lhs.line, lhs.column, lhs.rule) < std::tie(rhs.line, rhs.column, rhs.rule);
+    });
+
+    return found;
+  }
+
+  auto find(feedback::rules const& rules, feedback::workflow const& workflow, std::vector<buffer> const& buffers)
+  -> std::vector<finding> {
+    auto found = std::vector<std::vector<finding>>(buffers.size());
+    std::transform(std::execution::par, cbegin(buffers), cend(buffers), begin(found),
+                   [&](buffer const& source) { return find(rules, workflow, source); });
+
+    auto sorted = std::vector<std::size_t>(buffers.size());
+    for (std::size_t index = 0; index < sorted.size(); ++index)
+      sorted[index] = index;
+
+    std::stable_sort(begin(sorted), end(sorted),
+                     [&](std::size_t lhs, std::size_t rhs) { return buffers[lhs].path < buffers[rhs].path; });
+
+    auto merged = std::vector<finding>{};
+    for (auto const index : sorted)
+      std::move(begin(found[index]), end(found[index]), std::back_inserter(merged));
+
+    return merged;
+  }
+} // namespace generator::scan
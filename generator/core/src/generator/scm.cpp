@@ -1,9 +1,14 @@
 #include "generator/scm.h"
 
+#include "generator/io.h"
 #include "generator/regex.h"
 #include "generator/text.h"
 
+#include <algorithm>
 #include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
 namespace generator::scm {
 
@@ -44,8 +49,139 @@ namespace generator::scm {
 
       return true;
     }
+
+    struct git_command {
+      std::string_view relevant_changes;
+      std::string_view arguments;
+      bool             untracked;
+    };
+
+    // keep in sync with the diff commands in FeedbackPrivate.cmake
+    constexpr git_command git_commands[] = {
+      { "all", "diff --unified=0 @{push}", true },
+      { "modified", "diff --unified=0", true },
+      { "modified_or_staged", "diff --unified=0 @", true },
+      { "staged", "diff --unified=0 --staged @", false },
+      { "staged_or_committed", "diff --unified=0 --staged @{push}", false },
+      { "committed", "log --unified=0 --branches --not --remotes --format=format:", false },
+    };
+
+    auto find_git_command(std::string_view relevant_changes) -> git_command const& {
+      for (auto const& command : git_commands)
+        if (command.relevant_changes == relevant_changes)
+          return command;
+
+      throw std::invalid_argument{ std::string{ "unknown relevant changes: " }.append(relevant_changes) };
+    }
+
+    auto quoted(std::string const& argument) -> std::string {
+#ifdef _WIN32
+      return '"' + argument + '"';
+#else
+      auto result = std::string{ "'" };
+      for (auto const ch : argument)
+        if (ch == '\'')
+          result.append("'\\''");
+        else
+          result.push_back(ch);
+
+      return result.append("'");
+#endif
+    }
+
+    // the sources as pathspecs of several git commands, each within the limits of a command line
+    auto pathspecs(std::vector<std::filesystem::path> const& sources) -> std::vector<std::string> {
+#ifdef _WIN32
+      auto constexpr max_command_length = std::size_t{ 8000 };
+#else
+      auto constexpr max_command_length = std::size_t{ 128000 };
+#endif
+
+      auto batches = std::vector<std::string>{ " --" };
+      for (auto const& source : sources) {
+        auto const pathspec = " " + quoted(source.generic_u8string());
+
+        if (batches.back().length() > 3 and batches.back().length() + pathspec.length() > max_command_length)
+          batches.emplace_back(" --");
+
+        batches.back().append(pathspec);
+      }
+
+      return batches;
+    }
+
+    // binary index of a parsed diff: header, path table, interval array and path names
+    struct index_header {
+      std::uint32_t magic;
+      std::uint32_t version;
+      std::uint64_t stamp;
+      std::uint64_t checksum;
+      std::uint32_t path_count;
+      std::uint32_t interval_count;
+    };
+
+    struct index_path {
+      std::uint32_t name_offset;
+      std::uint32_t name_length;
+      std::uint32_t first_interval;
+      std::uint32_t interval_count;
+    };
+
+    struct index_interval {
+      std::int32_t begin;
+      std::int32_t end;
+    };
+
+    constexpr auto index_magic   = std::uint32_t{ 0x58444246 }; // "FBDX"
+    constexpr auto index_version = std::uint32_t{ 1 };
+
+    auto fnv1a(std::string_view data, std::uint64_t hash = 14695981039346656037ull) noexcept {
+      for (auto const ch : data)
+        hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ull;
+
+      return hash;
+    }
+
+    template <class T> auto as_bytes(T const& value) noexcept {
+      return std::string_view{ reinterpret_cast<char const*>(&value), sizeof(value) };
+    }
+
+    template <class T> auto as_bytes(std::vector<T> const& values) noexcept {
+      return std::string_view{ reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T) };
+    }
+
+    template <class T> auto read_array(std::string_view& data, std::size_t count) -> std::optional<std::vector<T>> {
+      if (data.size() / sizeof(T) < count)
+        return std::nullopt;
+
+      auto values = std::vector<T>(count);
+      std::memcpy(values.data(), data.data(), count * sizeof(T));
+      data.remove_prefix(count * sizeof(T));
+
+      return values;
+    }
+
+    auto stamp_of(std::filesystem::path const& filename) {
+      auto const size = static_cast<std::uint64_t>(std::filesystem::file_size(filename));
+      auto const time = static_cast<std::int64_t>(std::filesystem::last_write_time(filename).time_since_epoch().count());
+
+      return fnv1a(as_bytes(time), fnv1a(as_bytes(size)));
+    }
   } // namespace
 
+  auto diff::changes::all_lines() -> changes {
+    auto all = changes{};
+    all.modified.assign(1, std::numeric_limits<int>::max(), true);
+    return all;
+  }
+
+  auto diff::changes::lines(int first, int last, changes merged) -> changes {
+    if (first <= last)
+      merged.modified.assign(first, last + 1, true);
+
+    return merged;
+  }
+
   auto diff::changes::parse_from(std::string_view block, changes merged) -> changes {
     int line_number = parse_starting_line(block);
     if (not line_number)
@@ -86,6 +222,129 @@ namespace generator::scm {
     return merged;
   }
 
+  auto diff::parse_untracked(std::string_view file_list, diff merged) -> diff {
+    while (not file_list.empty()) {
+      auto const length   = std::min(file_list.find_first_of(std::string_view{ "\0\n", 2 }), file_list.length());
+      auto const filename = file_list.substr(0, length);
+
+      if (not filename.empty())
+        merged.modifications[std::filesystem::path{ filename }] = changes::all_lines();
+
+      file_list.remove_prefix(std::min(length + 1, file_list.length()));
+    }
+
+    return merged;
+  }
+
+  auto diff::from_git(std::string_view relevant_changes, std::vector<std::filesystem::path> const& sources, diff merged)
+  -> diff {
+    auto const& command = find_git_command(relevant_changes);
+    if (sources.empty())
+      return merged;
+
+    // git is restricted to the given sources, which are passed in batches if they are too many for a single command
+    for (auto const& restriction : pathspecs(sources)) {
+      if (command.untracked)
+        merged = parse_untracked(
+        io::command_output("git ls-files -z --full-name --others --exclude-standard --exclude=build*/ --exclude=.vs*/" +
+                           restriction), std::move(merged));
+
+      merged = parse(io::command_output(std::string{ "git " }.append(command.arguments).append(restriction)), std::move(merged));
+    }
+
+    return merged;
+  }
+
+  auto diff::parse_indexed(std::filesystem::path const& filename, std::filesystem::path const& index_filename) -> diff {
+    if (!std::filesystem::exists(filename))
+      throw std::invalid_argument{ "file not found" };
+
+    auto const stamp = stamp_of(filename);
+
+    if (std::filesystem::exists(index_filename))
+      if (auto indexed = from_index(io::binary_content(index_filename), stamp))
+        return std::move(*indexed);
+
+    auto parsed = parse(io::content(filename));
+    io::replace_content(index_filename, parsed.to_index(stamp));
+
+    return parsed;
+  }
+
+  auto diff::from_index(std::string_view index, std::uint64_t stamp) -> std::optional<diff> {
+    auto header = index_header{};
+    if (index.size() < sizeof(header))
+      return std::nullopt;
+
+    std::memcpy(&header, index.data(), sizeof(header));
+    index.remove_prefix(sizeof(header));
+
+    if (header.magic != index_magic || header.version != index_version || header.stamp != stamp ||
+        header.checksum != fnv1a(index))
+      return std::nullopt;
+
+    auto const paths     = read_array<index_path>(index, header.path_count);
+    auto const intervals = read_array<index_interval>(index, header.interval_count);
+
+    if (not paths || not intervals)
+      return std::nullopt;
+
+    auto indexed = diff{};
+    indexed.modifications.reserve(paths->size());
+
+    for (auto const& path : *paths) {
+      if (index.size() < std::size_t{ path.name_offset } + path.name_length ||
+          intervals->size() < std::size_t{ path.first_interval } + path.interval_count)
+        return std::nullopt;
+
+      auto& modified = indexed.modifications[std::filesystem::u8path(index.substr(path.name_offset, path.name_length))];
+
+      for (auto i = path.first_interval; i < path.first_interval + path.interval_count; ++i)
+        modified.modified.assign((*intervals)[i].begin, (*intervals)[i].end, true);
+    }
+
+    return indexed;
+  }
+
+  auto diff::to_index(std::uint64_t stamp) const -> std::string {
+    auto paths     = std::vector<index_path>{};
+    auto intervals = std::vector<index_interval>{};
+    auto names     = std::string{};
+
+    for (auto const& [filename, changed_lines] : modifications) {
+      auto const name  = filename.generic_u8string();
+      auto       entry = index_path{ static_cast<std::uint32_t>(names.size()), static_cast<std::uint32_t>(name.size()),
+                               static_cast<std::uint32_t>(intervals.size()), 0 };
+
+      names.append(name);
+
+      auto begin = std::optional<int>{};
+      for (auto const& [line, modified] : changed_lines.modified)
+        if (modified)
+          begin = line;
+        else if (begin)
+          intervals.push_back({ *begin, line }), begin.reset();
+
+      if (begin)
+        intervals.push_back({ *begin, std::numeric_limits<int>::max() });
+
+      entry.interval_count = static_cast<std::uint32_t>(intervals.size()) - entry.first_interval;
+      paths.push_back(entry);
+    }
+
+    auto payload = std::string{ as_bytes(paths) };
+    payload.append(as_bytes(intervals)).append(names);
+
+    auto const header = index_header{ index_magic,
+                                      index_version,
+                                      stamp,
+                                      fnv1a(payload),
+                                      static_cast<std::uint32_t>(paths.size()),
+                                      static_cast<std::uint32_t>(intervals.size()) };
+
+    return std::string{ as_bytes(header) }.append(payload);
+  }
+
   void diff::parse_section(std::string_view section) {
     auto const filename = parse_filename(section);
     if (filename.empty())
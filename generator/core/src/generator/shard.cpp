@@ -0,0 +1,216 @@
+#include "generator/shard.h"
+
+#include "generator/text.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+
+namespace generator::shard {
+
+  namespace {
+    auto fnv1a(std::string_view data) noexcept {
+      auto hash = std::uint64_t{ 14695981039346656037ull };
+      for (auto const ch : data)
+        hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ull;
+
+      return hash;
+    }
+
+    auto to_json(container::occupancy const& queue) -> nlohmann::json {
+      return { { "capacity", queue.capacity },
+               { "peak", queue.peak },
+               { "pushed", queue.pushed },
+               { "blocked", queue.blocked },
+               { "starved", queue.starved } };
+    }
+
+    auto occupancy_of(nlohmann::json const& json) -> container::occupancy {
+      auto queue     = container::occupancy{};
+      queue.capacity = json.value("capacity", queue.capacity);
+      queue.peak     = json.value("peak", queue.peak);
+      queue.pushed   = json.value("pushed", queue.pushed);
+      queue.blocked  = json.value("blocked", queue.blocked);
+      queue.starved  = json.value("starved", queue.starved);
+      return queue;
+    }
+
+    auto parse_number(std::string_view text) -> std::size_t {
+      auto number = std::size_t{ 0 };
+      auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+
+      if (result.ec != std::errc{} or result.ptr != text.data() + text.size())
+        throw std::invalid_argument{ "invalid shard: " + std::string{ text } };
+
+      return number;
+    }
+
+    auto by_hash(std::vector<std::filesystem::path> const& sources, std::size_t count) {
+      auto shards = std::vector<std::size_t>{};
+      shards.reserve(sources.size());
+
+      for (auto const& source : sources)
+        shards.push_back(fnv1a(source.generic_u8string()) % count);
+
+      return shards;
+    }
+
+    // the largest sources first, each one into the bin with the smallest total size so far
+    auto by_size(std::vector<std::filesystem::path> const& sources, std::size_t count) {
+      struct sized {
+        std::uintmax_t size;
+        std::size_t    index;
+      };
+
+      auto sorted = std::vector<sized>{};
+      sorted.reserve(sources.size());
+
+      for (std::size_t index = 0; index < sources.size(); ++index) {
+        auto error = std::error_code{};
+        auto size  = std::filesystem::file_size(sources[index], error);
+
+        sorted.push_back({ error ? 0 : size, index });
+      }
+
+      std::sort(begin(sorted), end(sorted), [&](sized const& lhs, sized const& rhs) {
+        return std::tie(rhs.size, sources[lhs.index]) < std::tie(lhs.size, sources[rhs.index]);
+      });
+
+      auto shards = std::vector<std::size_t>(sources.size());
+      auto totals = std::vector<std::uintmax_t>(count);
+
+      for (auto const& source : sorted) {
+        auto const smallest  = static_cast<std::size_t>(std::min_element(begin(totals), end(totals)) - begin(totals));
+        shards[source.index] = smallest;
+        totals[smallest] += source.size;
+      }
+
+      return shards;
+    }
+  } // namespace
+
+  auto to_partitioning(std::string_view name) -> partitioning {
+    if (name == "hash")
+      return partitioning::hash;
+    if (name == "size")
+      return partitioning::size;
+
+    throw std::invalid_argument{ "unknown shard partitioning: " + std::string{ name } };
+  }
+
+  auto parse(std::string_view text, partitioning by) -> selection {
+    auto const slash = text.find('/');
+    if (slash == std::string_view::npos)
+      throw std::invalid_argument{ "invalid shard: " + std::string{ text } };
+
+    auto const index = parse_number(text.substr(0, slash));
+    auto const count = parse_number(text.substr(slash + 1));
+
+    if (index < 1 or index > count)
+      throw std::invalid_argument{ "invalid shard: " + std::string{ text } };
+
+    return { index, count, by };
+  }
+
+  auto select(std::vector<std::filesystem::path> const& sources, selection shard) -> std::vector<std::filesystem::path> {
+    if (shard.count <= 1)
+      return sources;
+
+    auto const shards = shard.by == partitioning::size ? by_size(sources, shard.count) : by_hash(sources, shard.count);
+
+    auto selected = std::vector<std::filesystem::path>{};
+    for (std::size_t index = 0; index < sources.size(); ++index)
+      if (shards[index] == shard.index - 1)
+        selected.push_back(sources[index]);
+
+    return selected;
+  }
+
+  auto to_json(output::stats const& stats) -> std::string {
+    auto unscanned = nlohmann::json::array();
+    for (auto const& source : stats.unscanned)
+      unscanned.push_back(source.generic_u8string());
+
+    return nlohmann::json{ { "sources", stats.sources },
+                           { "bytes", stats.bytes },
+                           { "unscanned", unscanned },
+                           { "suppressed_after", stats.suppressed_after },
+                           { "stopped_after", stats.stopped_after },
+                           { "read_queue", to_json(stats.read_queue) },
+                           { "section_queue", to_json(stats.section_queue) } }
+    .dump(2);
+  }
+
+  auto parse_stats(std::string_view json) -> output::stats {
+    auto const parsed = nlohmann::json::parse(json);
+
+    auto stats    = output::stats{};
+    stats.sources = parsed.at("sources").get<std::size_t>();
+    stats.bytes   = parsed.at("bytes").get<std::size_t>();
+
+    for (auto const& source : parsed.value("unscanned", nlohmann::json::array()))
+      stats.unscanned.push_back(std::filesystem::u8path(source.get<std::string>()));
+
+    stats.suppressed_after = parsed.value("suppressed_after", std::string{});
+    stats.stopped_after    = parsed.value("stopped_after", std::string{});
+
+    stats.read_queue    = occupancy_of(parsed.value("read_queue", nlohmann::json::object()));
+    stats.section_queue = occupancy_of(parsed.value("section_queue", nlohmann::json::object()));
+
+    return stats;
+  }
+
+  auto parse_generated(std::string_view generated) -> generated_file {
+    constexpr auto section_start = std::string_view{ "\n#line 1 \"" };
+
+    auto parsed   = generated_file{};
+    auto begin    = generated.find(section_start);
+    parsed.header = generated.substr(0, begin);
+
+    while (begin != std::string_view::npos) {
+      auto const end = generated.find(section_start, begin + 1);
+      parsed.sections.push_back(generated.substr(begin, end == std::string_view::npos ? end : end - begin));
+      begin = end;
+    }
+
+    return parsed;
+  }
+
+  auto directive_of(std::string_view section) -> std::string_view {
+    return text::first_line_of(section.substr(1));
+  }
+
+  auto merge(std::vector<std::string> const& generated, std::filesystem::path const& rules_origin,
+             output::stats const& merged_stats) -> std::string {
+    auto const notes_directive = "#line 1 \"" + rules_origin.generic_u8string() + '"';
+
+    auto header   = std::string_view{};
+    auto sections = std::vector<std::string_view>{};
+
+    for (auto const& file : generated) {
+      auto const parsed = parse_generated(file);
+
+      if (header.empty())
+        header = parsed.header;
+
+      std::copy_if(cbegin(parsed.sections), cend(parsed.sections), std::back_inserter(sections),
+                   [&](auto const& section) { return directive_of(section) != notes_directive; });
+    }
+
+    // the shards finish their sources in any order, sorting makes the merged file independent of it
+    std::stable_sort(begin(sections), end(sections),
+                     [](auto const& lhs, auto const& rhs) { return directive_of(lhs) < directive_of(rhs); });
+
+    auto merged = std::string{ header };
+    for (auto const& section : sections)
+      merged.append(section);
+
+    return merged + output::notes(rules_origin, merged_stats);
+  }
+} // namespace generator::shard
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <execution>
+#include <numeric>
 
 namespace generator::text {
 
@@ -14,7 +16,8 @@ namespace generator::text {
     }
   } // namespace
 
-  excerpt::excerpt(std::string_view text, std::string_view match) {
+  excerpt::excerpt(std::string_view text, std::string_view match, std::pmr::memory_resource* resource)
+  : indentation(resource), annotation(resource) {
     assert(text.data() <= match.data());
     assert(text.data() + text.length() >= match.data() + match.length());
 
@@ -27,11 +30,51 @@ namespace generator::text {
       annotation[0] = '^';
   }
 
-  auto forward_search::highlighted_text(regex::precompiled const& pattern) const -> excerpt {
-    if (auto highlighting = forward_search{ matched_text() }; highlighting.next(pattern))
-      return { matched_lines(), highlighting.matched_text() };
+  auto window_length(std::string_view text, std::size_t size) noexcept -> std::size_t {
+    if (text.length() <= size)
+      return text.length();
+
+    auto const last_newline = text.substr(0, size).find_last_of('\n');
+    return last_newline == std::string_view::npos ? size : last_newline + 1;
+  }
+
+  auto split(std::string_view text, std::size_t size) -> std::vector<window> {
+    if (size == 0 or text.length() <= size)
+      return { window::whole(text) };
+
+    auto windows = std::vector<window>{};
+    for (auto offset = std::size_t{ 0 }; offset < text.length();) {
+      auto const rest       = text.substr(offset);
+      auto const own_length = window_length(rest, size);
+
+      windows.push_back({ text, rest.substr(0, own_length + size), own_length, 0, offset });
+      offset += own_length;
+    }
+
+    // the lines of all windows are counted in parallel, then accumulated
+    auto lines = std::vector<std::ptrdiff_t>(windows.size());
+    std::transform(std::execution::par, cbegin(windows), cend(windows), begin(lines), [](window const& counted) {
+      return std::count(counted.text.data(), counted.text.data() + counted.own_length, '\n');
+    });
+
+    std::exclusive_scan(cbegin(lines), cend(lines), begin(lines), std::ptrdiff_t{ 0 });
+
+    for (std::size_t index = 0; index < windows.size(); ++index)
+      windows[index].preceding_lines = lines[index];
+
+    return windows;
+  }
+
+  auto highlight(std::string_view matched_lines, std::string_view matched_text, regex::precompiled const& pattern,
+                 std::pmr::memory_resource* resource) -> excerpt {
+    if (auto highlighting = forward_search{ matched_text }; highlighting.next(pattern))
+      return { matched_lines, highlighting.matched_text(), resource };
+
+    return { matched_lines, matched_text, resource };
+  }
 
-    return { matched_lines(), matched_text() };
+  auto forward_search::highlighted_text(regex::precompiled const& pattern) const -> excerpt {
+    return highlight(matched_lines(), matched_text(), pattern);
   }
 
   auto forward_search::next(regex::precompiled const& pattern) -> bool {
@@ -39,7 +82,14 @@ namespace generator::text {
 
     std::string_view no_match;
 
-    if (!pattern.find(remaining, &current_match, &no_match, &remaining))
+    // ^ matches where the search starts or resumes, but not within the context, $ only at the end of the context
+    auto const context_end      = context.data() + context.length();
+    auto const context_begin    = resumed ? remaining.data() : context.data();
+    auto const relevant_context = std::string_view{ context_begin, static_cast<std::size_t>(context_end - context_begin) };
+
+    resumed = true;
+
+    if (!pattern.find(remaining, relevant_context, &current_match, &no_match, &remaining))
       return false;
 
     skip(no_match);
@@ -62,6 +112,15 @@ namespace generator::text {
     return last_processed_line | current_match | first_remaining_line;
   }
 
+  void forward_search::resume_at(std::size_t length) {
+    skip(current_match);
+    skip(remaining.substr(0, length));
+
+    current_match = remaining.substr(std::min(length, remaining.length()), 0);
+    remaining.remove_prefix(std::min(length, remaining.length()));
+    resumed = true;
+  }
+
   void forward_search::skip(std::string_view const& text) {
     processed = processed | text;
     processed_line_count += std::count(begin(text), end(text), '\n');
@@ -0,0 +1,49 @@
+#include "generator/trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <unordered_map>
+
+namespace generator::trace {
+
+  recorder::recorder() : start_(clock::now()) {
+  }
+
+  void recorder::record(std::string_view name, std::string_view detail, clock::time_point begin, clock::time_point end) {
+    auto const thread = std::this_thread::get_id();
+    auto const locked = std::lock_guard{ mutex_ };
+
+    events_.push_back({ std::string{ name }, std::string{ detail }, begin, end, thread });
+  }
+
+  auto recorder::to_json() const -> std::string {
+    auto const locked = std::lock_guard{ mutex_ };
+
+    auto const microseconds = [](clock::duration time) {
+      return std::chrono::duration<double, std::micro>{ time }.count();
+    };
+
+    // small sequential thread ids are easier to read in a trace viewer
+    auto thread_ids = std::unordered_map<std::thread::id, int>{};
+    auto events     = nlohmann::json::array();
+
+    for (auto const& event : events_) {
+      auto const tid = thread_ids.emplace(event.thread, static_cast<int>(thread_ids.size()) + 1).first->second;
+
+      auto json = nlohmann::json{ { "name", event.name },
+                                  { "cat", "generator" },
+                                  { "ph", "X" },
+                                  { "ts", microseconds(event.begin - start_) },
+                                  { "dur", microseconds(event.end - event.begin) },
+                                  { "pid", 1 },
+                                  { "tid", tid } };
+
+      if (not event.detail.empty())
+        json["args"] = { { "detail", event.detail } };
+
+      events.push_back(std::move(json));
+    }
+
+    return nlohmann::json{ { "traceEvents", events }, { "displayTimeUnit", "ms" } }.dump();
+  }
+} // namespace generator::trace
@@ -0,0 +1,156 @@
+#include "generator/watch.h"
+
+#include "generator/format.h"
+#include "generator/shard.h"
+
+#include <algorithm>
+#include <array>
+#include <set>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace generator::watch {
+
+  namespace {
+    auto directive_of(std::filesystem::path const& source) {
+      return fmt::format("#line 1 \"{}\"", source.generic_u8string());
+    }
+  } // namespace
+
+  results::results(std::filesystem::path const& rules_origin) : notes_directive_(directive_of(rules_origin)) {
+  }
+
+  void results::update(std::string_view generated) {
+    auto const parsed = shard::parse_generated(generated);
+
+    // the notes of a previous run are outdated, whether or not the new one has any
+    header_ = parsed.header;
+    sections_.erase(notes_directive_);
+
+    for (auto const& section : parsed.sections)
+      sections_.erase(std::string{ shard::directive_of(section) });
+
+    for (auto const& section : parsed.sections)
+      sections_[std::string{ shard::directive_of(section) }].append(section);
+  }
+
+  void results::remove(std::filesystem::path const& source) {
+    sections_.erase(directive_of(source));
+  }
+
+  void results::clear() {
+    header_.clear();
+    sections_.clear();
+  }
+
+  auto results::to_string() const -> std::string {
+    auto generated = header_;
+    for (auto const& [directive, section] : sections_)
+      generated += section;
+
+    return generated;
+  }
+
+#ifdef __linux__
+  watcher::watcher(std::vector<std::filesystem::path> const& files) : fd_(::inotify_init1(IN_CLOEXEC)) {
+    if (fd_ < 0)
+      throw std::runtime_error{ "failed to initialize inotify" };
+
+    auto directories = std::set<std::filesystem::path>{};
+    for (auto const& file : files) {
+      // the key of a watched file is independent of how it was spelled
+      auto const key = std::filesystem::absolute(file).lexically_normal();
+
+      files_.emplace(key, file);
+      directories.insert(key.parent_path());
+    }
+
+    constexpr auto events = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+    for (auto const& directory : directories) {
+      auto const wd = ::inotify_add_watch(fd_, directory.c_str(), events);
+      if (wd < 0) {
+        ::close(fd_);
+        throw std::invalid_argument{ "failed to watch directory: " + directory.u8string() };
+      }
+
+      directories_.emplace(wd, directory);
+    }
+  }
+
+  watcher::~watcher() {
+    ::close(fd_);
+  }
+
+  auto watcher::wait(std::chrono::milliseconds latency) -> std::vector<std::filesystem::path> {
+    auto changed    = std::set<std::filesystem::path>{};
+    auto buffer     = std::array<char, 64 * 1024>{};
+    auto timeout    = -1;
+    auto overflowed = false;
+
+    // an editor saving a file causes several events, which are reported together
+    while (true) {
+      auto ready = pollfd{ fd_, POLLIN, 0 };
+      auto count = ::poll(&ready, 1, timeout);
+
+      if (count < 0 and errno == EINTR)
+        continue;
+      if (count < 0)
+        throw std::runtime_error{ "failed to wait for changes" };
+      if (count == 0)
+        break;
+
+      auto const length = ::read(fd_, buffer.data(), buffer.size());
+      if (length < 0 and errno == EINTR)
+        continue;
+      if (length < 0)
+        throw std::runtime_error{ "failed to read changes" };
+
+      for (auto offset = std::size_t{ 0 }; offset < static_cast<std::size_t>(length);) {
+        auto event = inotify_event{};
+        std::copy_n(buffer.data() + offset, sizeof(event), reinterpret_cast<char*>(&event));
+
+        // the queue dropped events, which may have been of any watched file
+        if (event.mask & IN_Q_OVERFLOW)
+          overflowed = true;
+
+        auto const directory = directories_.find(event.wd);
+        if (directory != end(directories_) and event.len > 0) {
+          auto const name = std::string_view{ buffer.data() + offset + sizeof(event) };
+          auto const file = files_.find(directory->second / name);
+
+          if (file != end(files_))
+            changed.insert(file->second);
+        }
+
+        offset += sizeof(event) + event.len;
+      }
+
+      if (overflowed or not changed.empty())
+        timeout = static_cast<int>(latency.count());
+    }
+
+    if (overflowed)
+      for (auto const& [key, file] : files_)
+        changed.insert(file);
+
+    return { begin(changed), end(changed) };
+  }
+#else
+  watcher::watcher(std::vector<std::filesystem::path> const&) {
+    throw std::runtime_error{ "watching sources requires inotify, which is only available on Linux" };
+  }
+
+  watcher::~watcher() = default;
+
+  auto watcher::wait(std::chrono::milliseconds) -> std::vector<std::filesystem::path> {
+    return {};
+  }
+#endif
+} // namespace generator::watch
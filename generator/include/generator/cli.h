@@ -1,12 +1,52 @@
 #pragma once
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace generator::cli {
+  using filenames = std::vector<std::filesystem::path>;
+
   struct parameters {
     std::filesystem::path diff_filename;
+    std::filesystem::path diff_index_filename;
+    bool                  index_only{ false };
+    std::string           relevant_changes;
     std::filesystem::path rules_filename;
     std::filesystem::path workflow_filename;
     std::filesystem::path sources_filename;
+    std::filesystem::path compile_commands_filename;
+    std::string           compile_commands_target;
+    bool                  headers_from_depfiles{ false };
+    std::filesystem::path written_depfile_filename;
+    std::filesystem::path output_filename;
+    bool                  watch{ false };
+    std::filesystem::path profile_filename;
+    std::size_t           profile_top_count{ 20 };
+    std::filesystem::path trace_filename;
+    std::filesystem::path memory_filename;
+    std::size_t           max_findings{ 0 };
+    std::size_t           max_errors{ 0 };
+    std::size_t           max_findings_per_rule{ 0 };
+    std::size_t           max_findings_per_file{ 0 };
+    int                   time_budget{ 0 };
+    std::filesystem::path unscanned_filename;
+    std::size_t           window_size{ 0 };
+    std::size_t           segment_size{ 0 };
+    std::size_t           scanners{ 0 };
+    std::size_t           read_ahead{ 0 };
+    std::size_t           pending_sections{ 0 };
+    std::string           shard;
+    std::string           shard_by{ "hash" };
+    std::filesystem::path stats_filename;
+    filenames             merged_filenames;
+    filenames             merged_stats_filenames;
+    std::filesystem::path baseline_filename;
+    std::filesystem::path written_baseline_filename;
+    bool                  analyze_rules{ false };
+    std::int64_t          memory_budget{ 8 << 20 };
+    int                   max_program_size{ 0 };
+    double                min_throughput{ 0 };
   };
 
   auto parse(int argc, char* argv[]) -> parameters;
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace generator::corpus {
+
+  struct options {
+    std::size_t   file_count{ 100 };
+    std::size_t   min_lines{ 200 };
+    std::size_t   max_lines{ 2000 };
+    double        match_density{ 0.01 }; // fraction of lines violating one of the example rules
+    std::size_t   changed_files{ 10 };
+    std::size_t   hunks_per_file{ 10 };
+    std::uint64_t seed{ 42 };
+  };
+
+  struct source {
+    std::filesystem::path filename; // relative to the corpus directory
+    std::string           content;
+  };
+
+  // the same options always yield the same corpus, independent of platform and standard library
+  auto make_sources(corpus::options const& options) -> std::vector<source>;
+  auto make_diff(std::vector<source> const& sources, corpus::options const& options) -> std::string;
+
+  // writes the sources, a sources.txt file list and a changes.diff below the directory
+  void write(std::filesystem::path const& directory, corpus::options const& options);
+} // namespace generator::corpus
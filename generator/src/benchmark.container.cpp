@@ -0,0 +1,34 @@
+#include "generator/container.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_IntervalMapAssign(benchmark::State& state) {
+  auto const count = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    auto changes = generator::container::interval_map<int, bool>{ false };
+
+    for (auto line = 1; line < 10 * count; line += 10)
+      changes.assign(line, line + 3, true);
+
+    benchmark::DoNotOptimize(changes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_IntervalMapAssign)->Arg(100)->Arg(10000);
+
+static void BM_IntervalMapLookup(benchmark::State& state) {
+  auto const count   = static_cast<int>(state.range(0));
+  auto       changes = generator::container::interval_map<int, bool>{ false };
+
+  for (auto line = 1; line < 10 * count; line += 10)
+    changes.assign(line, line + 3, true);
+
+  for (auto _ : state)
+    for (auto line = 1; line < 10 * count; ++line)
+      benchmark::DoNotOptimize(changes[line]);
+
+  state.SetItemsProcessed(state.iterations() * 10 * count);
+}
+BENCHMARK(BM_IntervalMapLookup)->Arg(100)->Arg(10000);
@@ -0,0 +1,112 @@
+#include "generator/format.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+  // the former character by character escaping, kept as a reference for the bulk kernel
+  struct as_legacy_compiler_message {
+    std::string_view str;
+  };
+
+  auto make_text(benchmark::State const& state, std::string_view line) {
+    auto text = std::string{};
+    while (text.size() < static_cast<std::size_t>(state.range(0)))
+      text += line;
+
+    return text;
+  }
+
+  constexpr auto feedback_line =
+  "GUIDELINE1: avoid \"tabs\" [ requirement from file://C:\\rules.json ]\nrationale  : mixed indentation\r\n";
+
+  constexpr auto source_line = "    auto const value = compute(index, offset) * limit + std::size(items); // computes\n";
+} // namespace
+
+namespace fmt {
+
+  template <> struct formatter<as_legacy_compiler_message> {
+    template <typename ParseContext> constexpr auto parse(ParseContext& ctx) {
+      return ctx.begin();
+    }
+
+    template <typename FormatContext> auto format(as_legacy_compiler_message const& text, FormatContext& ctx) {
+      auto out = ctx.out();
+
+      bool indent{ false };
+
+      for (auto const& ch : text.str) {
+        if (indent) {
+          for (auto const indentation : "      | ")
+            if (indentation != '\0')
+              out = base.format(indentation, ctx);
+          indent = false;
+        }
+
+        switch (ch) {
+        case '\n':
+          out    = base.format('\\', ctx);
+          out    = base.format('n', ctx);
+          indent = true;
+          break;
+        case '\r':
+          break;
+        case '\\':
+          [[fallthrough]];
+        case '\"':
+          out = base.format('\\', ctx);
+          [[fallthrough]];
+        default:
+          out = base.format(ch, ctx);
+          break;
+        }
+      }
+
+      return out;
+    }
+
+  private:
+    formatter<char> base;
+  };
+} // namespace fmt
+
+static void BM_AsCompilerMessage(benchmark::State& state) {
+  auto const text = make_text(state, feedback_line);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fmt::format("{}", generator::format::as_compiler_message{ text }));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_AsCompilerMessage)->Arg(256)->Arg(64 << 10);
+
+static void BM_AsLegacyCompilerMessage(benchmark::State& state) {
+  auto const text = make_text(state, feedback_line);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fmt::format("{}", as_legacy_compiler_message{ text }));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_AsLegacyCompilerMessage)->Arg(256)->Arg(64 << 10);
+
+static void BM_AsCompilerMessageSourceLine(benchmark::State& state) {
+  auto const text = make_text(state, source_line);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fmt::format("{}", generator::format::as_compiler_message{ text }));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_AsCompilerMessageSourceLine)->Arg(256)->Arg(64 << 10);
+
+static void BM_AsLegacyCompilerMessageSourceLine(benchmark::State& state) {
+  auto const text = make_text(state, source_line);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fmt::format("{}", as_legacy_compiler_message{ text }));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_AsLegacyCompilerMessageSourceLine)->Arg(256)->Arg(64 << 10);
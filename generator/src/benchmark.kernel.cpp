@@ -0,0 +1,48 @@
+#include "generator/regex.h"
+#include "generator/text.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+  // mostly clean lines, as in a maintained code base, with a rare violation of each check
+  auto make_text(std::size_t size) {
+    constexpr auto clean_line = "    auto const value = compute(index, offset) * limit + std::size(items); // computes\n";
+    constexpr auto dirty_line =
+    "\tauto const text = \"gr\xc3\xbc\xc3\x9f\"; // a comment which makes this line longer than the 120 bytes of a long line, which is really way too long \r\n";
+
+    auto text = std::string{};
+    for (auto line = 0; text.size() < size; ++line)
+      text += line % 100 == 99 ? dirty_line : clean_line;
+
+    return text;
+  }
+
+  void find(benchmark::State& state, generator::regex::precompiled const& pattern) {
+    auto const text = make_text(1 << 20);
+
+    for (auto _ : state) {
+      auto search = generator::text::forward_search{ text };
+      auto count  = 0;
+
+      while (search.next(pattern))
+        ++count;
+
+      benchmark::DoNotOptimize(count);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+  }
+} // namespace
+
+BENCHMARK_CAPTURE(find, tab_kernel, generator::regex::builtin("tab"));
+BENCHMARK_CAPTURE(find, tab_regex, generator::regex::capture("\t"));
+BENCHMARK_CAPTURE(find, trailing_whitespace_kernel, generator::regex::builtin("trailing_whitespace"));
+BENCHMARK_CAPTURE(find, trailing_whitespace_regex, generator::regex::compile("(?m)([ \t]+\r?)$"));
+BENCHMARK_CAPTURE(find, crlf_kernel, generator::regex::builtin("crlf"));
+BENCHMARK_CAPTURE(find, crlf_regex, generator::regex::capture("\r\n"));
+BENCHMARK_CAPTURE(find, non_ascii_kernel, generator::regex::builtin("non_ascii"));
+BENCHMARK_CAPTURE(find, non_ascii_regex, generator::regex::capture("[^\\x00-\\x7f]+"));
+BENCHMARK_CAPTURE(find, long_line_kernel, generator::regex::builtin("long_line:120"));
+BENCHMARK_CAPTURE(find, long_line_regex, generator::regex::compile("(?m)^[^\r\n]{120}([^\r\n]+)"));
@@ -1,3 +1,129 @@
+#include "generator/io.h"
+
 #include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+  using throughputs = std::map<std::string, double>;
+
+  // collects the throughput of each run: bytes, items or iterations per second of real time
+  class recording_reporter : public benchmark::ConsoleReporter {
+  public:
+    void ReportRuns(std::vector<Run> const& runs) override {
+      ConsoleReporter::ReportRuns(runs);
+
+      for (auto const& run : runs) {
+        if (run.error_occurred or run.run_type != Run::RT_Iteration)
+          continue;
+
+        auto const throughput = throughput_of(run);
+        auto&      recorded   = recorded_throughputs[run.benchmark_name()];
+
+        // keep the best repetition, which is least affected by noise
+        if (throughput > recorded)
+          recorded = throughput;
+      }
+    }
+
+    auto throughputs() const -> ::throughputs const& {
+      return recorded_throughputs;
+    }
+
+  private:
+    static auto throughput_of(Run const& run) -> double {
+      for (auto const* counter : { "bytes_per_second", "items_per_second" })
+        if (auto const position = run.counters.find(counter); position != run.counters.end())
+          return position->second;
+
+      if (run.real_accumulated_time <= 0)
+        return 0;
+
+      return static_cast<double>(run.iterations) / run.real_accumulated_time;
+    }
+
+    ::throughputs recorded_throughputs;
+  };
+
+  struct options {
+    std::string baseline_filename;
+    std::string updated_baseline_filename;
+    double      tolerance{ 0.25 };
+  };
+
+  // removes the options of the regression gate, the remaining ones are passed to google benchmark
+  auto extract_options(int& argc, char* argv[]) -> options {
+    auto result = options{};
+    auto kept   = 1;
+
+    for (auto index = 1; index < argc; ++index) {
+      auto const argument = std::string{ argv[index] };
+
+      if (argument.rfind("--baseline=", 0) == 0)
+        result.baseline_filename = argument.substr(std::strlen("--baseline="));
+      else if (argument.rfind("--update-baseline=", 0) == 0)
+        result.updated_baseline_filename = argument.substr(std::strlen("--update-baseline="));
+      else if (argument.rfind("--tolerance=", 0) == 0)
+        result.tolerance = std::stod(argument.substr(std::strlen("--tolerance=")));
+      else
+        argv[kept++] = argv[index];
+    }
+
+    argc = kept;
+    return result;
+  }
+
+  auto compare(throughputs const& measured, throughputs const& baseline, double tolerance) -> int {
+    auto regressions = 0;
+
+    for (auto const& [name, expected] : baseline) {
+      auto const position = measured.find(name);
+      if (position == measured.end()) {
+        std::cerr << name << ": not measured\n";
+        ++regressions;
+        continue;
+      }
+
+      auto const ratio = position->second / expected;
+      if (ratio < 1.0 - tolerance) {
+        std::cerr << name << ": throughput dropped to " << static_cast<int>(ratio * 100) << "% of the baseline\n";
+        ++regressions;
+      }
+    }
+
+    return regressions == 0 ? 0 : 1;
+  }
+} // namespace
+
+int main(int argc, char* argv[]) {
+  try {
+    auto const options = extract_options(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+      return 1;
+
+    auto reporter = recording_reporter{};
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+
+    if (not options.updated_baseline_filename.empty())
+      generator::io::replace_content(options.updated_baseline_filename,
+                                     nlohmann::json(reporter.throughputs()).dump(2) + '\n');
+
+    if (not options.baseline_filename.empty())
+      return compare(reporter.throughputs(),
+                     nlohmann::json::parse(generator::io::content(options.baseline_filename)).get<throughputs>(),
+                     options.tolerance);
+  }
+  catch (std::exception const& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
 
-BENCHMARK_MAIN();
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "generator/corpus.h"
+#include "generator/io.h"
+#include "generator/json.h"
+#include "generator/output.h"
+
+#include <benchmark/benchmark.h>
+
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+namespace {
+  // counts and discards the generated code, so the benchmark does not measure the terminal
+  class discarding_buffer : public std::streambuf {
+  protected:
+    auto overflow(int_type ch) -> int_type override {
+      return traits_type::not_eof(ch);
+    }
+
+    auto xsputn(char_type const*, std::streamsize count) -> std::streamsize override {
+      return count;
+    }
+  };
+
+  auto corpus_sources() -> std::vector<std::filesystem::path> const& {
+    static auto const sources = [] {
+      auto options       = generator::corpus::options{};
+      options.file_count = 200;
+
+      auto const directory = std::filesystem::temp_directory_path() / "generator.benchmark.corpus";
+      generator::corpus::write(directory, options);
+
+      auto list   = std::istringstream{ generator::io::content(directory / "sources.txt") };
+      auto result = std::vector<std::filesystem::path>{};
+
+      for (std::string source; std::getline(list, source);)
+        result.emplace_back(source);
+
+      return result;
+    }();
+
+    return sources;
+  }
+
+  void print(benchmark::State& state, std::filesystem::path const& rules_filename) {
+    auto const workflow = generator::json::parse_workflow(R"({ "default": { "check": "everything", "response": "warning" } })");
+    auto const rules    = generator::json::parse_rules(generator::io::content(rules_filename), workflow);
+
+    auto rules_promise    = std::promise<generator::feedback::rules>{};
+    auto sources_promise  = std::promise<std::vector<std::filesystem::path>>{};
+    auto workflow_promise = std::promise<generator::feedback::workflow>{};
+    auto diff_promise     = std::promise<generator::scm::diff>{};
+
+    rules_promise.set_value(rules);
+    sources_promise.set_value(corpus_sources());
+    workflow_promise.set_value(workflow);
+    diff_promise.set_value({});
+
+    auto const shared_rules    = rules_promise.get_future().share();
+    auto const shared_sources  = sources_promise.get_future().share();
+    auto const shared_workflow = workflow_promise.get_future().share();
+    auto const shared_diff     = diff_promise.get_future().share();
+
+    auto buffer = discarding_buffer{};
+    auto out    = std::ostream{ &buffer };
+    auto stats  = generator::output::stats{};
+
+    for (auto _ : state)
+      stats = generator::output::print(out, { rules_filename, shared_rules, shared_sources, shared_workflow, shared_diff });
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stats.bytes));
+  }
+} // namespace
+
+static void BM_PrintExampleRules(benchmark::State& state) {
+  print(state, GENERATOR_EXAMPLE_RULES);
+}
+BENCHMARK(BM_PrintExampleRules)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_PrintGuidelineRules(benchmark::State& state) {
+  print(state, GENERATOR_GUIDELINE_RULES);
+}
+BENCHMARK(BM_PrintGuidelineRules)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,36 @@
+#include "generator/corpus.h"
+#include "generator/io.h"
+#include "generator/json.h"
+#include "generator/scan.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+  void find(benchmark::State& state, std::filesystem::path const& rules_filename) {
+    auto const workflow = generator::json::parse_workflow(R"({ "default": { "check": "everything", "response": "warning" } })");
+    auto const rules    = generator::json::parse_rules(generator::io::content(rules_filename), workflow);
+
+    auto options       = generator::corpus::options{};
+    options.file_count = 1;
+    options.min_lines  = 2000;
+
+    auto const sources = generator::corpus::make_sources(options);
+    auto const content = sources.front().content;
+    auto const source  = generator::scan::buffer{ sources.front().filename, content, {} };
+
+    for (auto _ : state)
+      benchmark::DoNotOptimize(generator::scan::find(rules, workflow, source));
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * content.size()));
+  }
+} // namespace
+
+static void BM_FindInBufferExampleRules(benchmark::State& state) {
+  find(state, GENERATOR_EXAMPLE_RULES);
+}
+BENCHMARK(BM_FindInBufferExampleRules);
+
+static void BM_FindInBufferGuidelineRules(benchmark::State& state) {
+  find(state, GENERATOR_GUIDELINE_RULES);
+}
+BENCHMARK(BM_FindInBufferGuidelineRules);
@@ -0,0 +1,19 @@
+#include "generator/corpus.h"
+#include "generator/scm.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_DiffParse(benchmark::State& state) {
+  auto options           = generator::corpus::options{};
+  options.file_count     = static_cast<std::size_t>(state.range(0));
+  options.changed_files  = options.file_count;
+  options.hunks_per_file = 20;
+
+  auto const diff = generator::corpus::make_diff(generator::corpus::make_sources(options), options);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(generator::scm::diff::parse(diff));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * diff.size()));
+}
+BENCHMARK(BM_DiffParse)->Arg(10)->Arg(100);
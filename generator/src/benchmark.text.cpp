@@ -0,0 +1,27 @@
+#include "generator/corpus.h"
+#include "generator/regex.h"
+#include "generator/text.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_ForwardSearch(benchmark::State& state) {
+  auto options          = generator::corpus::options{};
+  options.file_count    = 1;
+  options.min_lines     = static_cast<std::size_t>(state.range(0));
+  options.max_lines     = options.min_lines;
+  options.match_density = 0.01;
+
+  auto const source  = generator::corpus::make_sources(options).front().content;
+  auto const pattern = generator::regex::compile("// *(TODO|FIXME|REVIEW|OPTIMIZE|HACK|XXX|BUG)");
+
+  for (auto _ : state) {
+    auto search  = generator::text::forward_search{ source };
+    auto matches = 0;
+
+    while (search.next(pattern))
+      benchmark::DoNotOptimize(matches += search.line());
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(BM_ForwardSearch)->Arg(1000)->Arg(100000);
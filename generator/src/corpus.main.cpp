@@ -0,0 +1,42 @@
+#include "generator/corpus.h"
+#include "generator/macros.h"
+
+COMPILER_WARNINGS_PUSH
+
+MSC_WARNING(disable : 4100)
+MSC_WARNING(disable : 4458)
+GCC_DIAGNOSTIC(ignored "-Wtype-limits")
+
+#include <lyra/lyra.hpp>
+
+COMPILER_WARNINGS_POP
+
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char* argv[]) {
+  auto options   = generator::corpus::options{};
+  auto directory = std::filesystem::path{};
+
+  auto const cli = lyra::opt(options.file_count, "count")["--files"]("number of source files") |
+                   lyra::opt(options.min_lines, "lines")["--min-lines"]("minimum number of lines per file") |
+                   lyra::opt(options.max_lines, "lines")["--max-lines"]("maximum number of lines per file") |
+                   lyra::opt(options.match_density, "fraction")["--match-density"]("fraction of violating lines") |
+                   lyra::opt(options.changed_files, "count")["--changed-files"]("number of files in the diff") |
+                   lyra::opt(options.hunks_per_file, "count")["--hunks"]("number of hunks per changed file") |
+                   lyra::opt(options.seed, "seed")["--seed"]("seed of the pseudo random generator") |
+                   lyra::arg(directory, "directory")("output directory").required();
+
+  try {
+    if (auto const result = cli.parse({ argc, argv }); not result)
+      throw std::invalid_argument{ result.errorMessage() };
+
+    generator::corpus::write(directory, options);
+  }
+  catch (std::exception const& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}
@@ -17,11 +17,69 @@ auto generator::cli::parse(int argc, char* argv[]) -> generator::cli::parameters
 
   auto const cli = lyra::opt(p.workflow_filename, "workflow filename")["-w"]["--workflow"]("JSON file with workflow") |
                    lyra::opt(p.diff_filename, "diff filename")["-d"]["--diff"]("diff file name") |
+                   lyra::opt(p.diff_index_filename, "diff index filename")["--diff-index"](
+                   "binary index of the diff file, rebuilt if stale") |
+                   lyra::opt(p.index_only)["--index-only"]("update the diff index and exit") |
+                   lyra::opt(p.relevant_changes, "relevant changes")["-c"]["--changes"]("detect changes with git")
+                   .choices("all", "modified", "modified_or_staged", "staged", "staged_or_committed", "committed") |
+                   lyra::opt(p.compile_commands_filename, "compile commands filename")["--compile-commands"](
+                   "scan the sources of this compilation database instead of a file list") |
+                   lyra::opt(p.compile_commands_target, "target")["--compile-commands-target"](
+                   "scan only the sources compiled for this CMake target") |
+                   lyra::opt(p.headers_from_depfiles)["--headers-from-depfiles"](
+                   "scan the headers listed in the depfiles of the compile commands as well") |
+                   lyra::opt(p.written_depfile_filename, "depfile filename")["--write-depfile"](
+                   "Makefile dependencies of --output on the rules, the workflow and the sources") |
+                   lyra::opt(p.output_filename, "output filename")["-o"]["--output"]("replace this file instead of printing") |
+                   lyra::opt(p.watch)["--watch"]("rescan changed sources into --output until terminated") |
+                   lyra::opt(p.profile_filename, "profile filename")["--profile"]("JSON file with per rule/file timings") |
+                   lyra::opt(p.profile_top_count, "count")["--profile-top"]("number of slowest rule/file pairs to profile") |
+                   lyra::opt(p.trace_filename, "trace filename")["--trace"]("Chrome trace event JSON timeline") |
+                   lyra::opt(p.memory_filename, "memory filename")["--memory"]("JSON file with peak RSS and allocations per phase") |
+                   lyra::opt(p.max_findings, "count")["--max-findings"]("stop after this number of findings") |
+                   lyra::opt(p.max_errors, "count")["--max-errors"]("stop after this number of errors") |
+                   lyra::opt(p.max_findings_per_rule, "count")["--max-findings-per-rule"]("findings of a rule per source") |
+                   lyra::opt(p.max_findings_per_file, "count")["--max-findings-per-file"]("findings of all rules per source") |
+                   lyra::opt(p.time_budget, "milliseconds")["--time-budget"]("scan changed sources first and stop in time") |
+                   lyra::opt(p.unscanned_filename, "unscanned filename")["--unscanned"]("file list of sources left unscanned") |
+                   lyra::opt(p.window_size, "bytes")["--window-size"]("scan larger sources in windows of this size") |
+                   lyra::opt(p.segment_size, "bytes")["--segment-size"]("scan larger sources in parallel segments of this size") |
+                   lyra::opt(p.scanners, "count")["--scanners"]("scan this many sources at once") |
+                   lyra::opt(p.read_ahead, "count")["--read-ahead"]("read at most this many sources ahead of the scanners") |
+                   lyra::opt(p.pending_sections, "count")["--pending-sections"]("scanned sources waiting for the writer") |
+                   lyra::opt(p.shard, "index/count")["--shard"]("scan only this shard of the sources, counted from 1") |
+                   lyra::opt(p.shard_by, "partitioning")["--shard-by"]("partition the sources by path hash or size")
+                   .choices("hash", "size") |
+                   lyra::opt(p.stats_filename, "stats filename")["--stats"]("JSON file with the stats of the run") |
+                   lyra::opt(p.merged_filenames, "generated filename")["--merge"]("merge the generated files of all shards") |
+                   lyra::opt(p.merged_stats_filenames, "stats filename")["--merge-stats"]("merge the stats of all shards") |
+                   lyra::opt(p.baseline_filename, "baseline filename")["--baseline"]("report only findings missing in this baseline") |
+                   lyra::opt(p.written_baseline_filename, "baseline filename")["--write-baseline"]("record all findings as baseline") |
+                   lyra::opt(p.analyze_rules)["--analyze-rules"]("report the cost of each rule instead of scanning") |
+                   lyra::opt(p.memory_budget, "bytes")["--memory-budget"]("regex memory budget for --analyze-rules") |
+                   lyra::opt(p.max_program_size, "size")["--max-program-size"]("fail --analyze-rules above this size") |
+                   lyra::opt(p.min_throughput, "MB/s")["--min-throughput"]("fail --analyze-rules below this throughput") |
                    lyra::arg(p.rules_filename, "rules filename")("JSON file with feedback rules") |
                    lyra::arg(p.sources_filename, "sources filename")("File list for source files to scan");
 
   if (auto const result = cli.parse({ argc, argv }); not result)
     throw std::invalid_argument{ result.errorMessage() };
 
+  if (p.index_only and (p.diff_filename.empty() or p.diff_index_filename.empty()))
+    throw std::invalid_argument{ "--index-only requires --diff and --diff-index" };
+
+  if (p.compile_commands_filename.empty() == p.sources_filename.empty() and not p.index_only and
+      p.merged_filenames.empty() and p.merged_stats_filenames.empty() and not p.analyze_rules)
+    throw std::invalid_argument{ "either a file list or --compile-commands is required" };
+
+  if ((not p.compile_commands_target.empty() or p.headers_from_depfiles) and p.compile_commands_filename.empty())
+    throw std::invalid_argument{ "--compile-commands-target and --headers-from-depfiles require --compile-commands" };
+
+  if (not p.written_depfile_filename.empty() and p.output_filename.empty())
+    throw std::invalid_argument{ "--write-depfile requires --output" };
+
+  if (p.watch and p.output_filename.empty())
+    throw std::invalid_argument{ "--watch requires --output" };
+
   return p;
 }
@@ -0,0 +1,144 @@
+#include "generator/corpus.h"
+
+#include "generator/format.h"
+#include "generator/io.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace generator::corpus {
+
+  namespace {
+    // splitmix64, since the distributions of <random> differ between standard libraries
+    class random {
+    public:
+      explicit random(std::uint64_t seed) noexcept : state(seed) {
+      }
+
+      auto next() noexcept -> std::uint64_t {
+        auto z = (state += 0x9E3779B97F4A7C15ull);
+        z      = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z      = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+      }
+
+      auto below(std::size_t bound) noexcept -> std::size_t {
+        return bound == 0 ? 0 : static_cast<std::size_t>(next() % bound);
+      }
+
+      auto between(std::size_t low, std::size_t high) noexcept -> std::size_t {
+        return low + below(high - low + 1);
+      }
+
+      auto chance(double probability) noexcept -> bool {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+      }
+
+    private:
+      std::uint64_t state;
+    };
+
+    constexpr std::string_view clean_lines[] = {
+      "#include <vector>",
+      "",
+      "namespace corpus {",
+      "  auto compute(int index, int offset) -> int {",
+      "    auto value = index * offset + 42;",
+      "    if (value > limit)",
+      "      return value - limit;",
+      "    for (auto const& item : items)",
+      "      value += item.weight;",
+      "    return value;",
+      "  }",
+      "  // computes the next value of the sequence",
+      "  std::vector<std::string> names{ \"first\", \"second\", \"third\" };",
+      "} // namespace corpus",
+    };
+
+    // each line violates at least one rule of examples/rules.json and doc/guidelines/rules.json
+    constexpr std::string_view violating_lines[] = {
+      "\tint tabbed = 0;",
+      "#include \"detail\\helper.h\"",
+      "#include <detail//helper.h>",
+      "#include<map>",
+      "  // TODO: remove this workaround",
+      "  value = 0; // FIXME: handle overflow",
+    };
+  } // namespace
+
+  auto make_sources(corpus::options const& options) -> std::vector<source> {
+    auto generator = random{ options.seed };
+    auto sources   = std::vector<source>{};
+
+    sources.reserve(options.file_count);
+
+    for (std::size_t index = 0; index < options.file_count; ++index) {
+      auto const line_count = generator.between(options.min_lines, std::max(options.min_lines, options.max_lines));
+      auto       content    = std::string{};
+
+      for (std::size_t line = 0; line < line_count; ++line) {
+        if (generator.chance(options.match_density))
+          content.append(violating_lines[generator.below(std::size(violating_lines))]);
+        else
+          content.append(clean_lines[generator.below(std::size(clean_lines))]);
+
+        content.push_back('\n');
+      }
+
+      sources.push_back({ std::filesystem::path{ "src" } / fmt::format("file{:05}.cpp", index), std::move(content) });
+    }
+
+    return sources;
+  }
+
+  auto make_diff(std::vector<source> const& sources, corpus::options const& options) -> std::string {
+    auto generator = random{ options.seed ^ 0xD1FFull };
+    auto diff      = std::string{};
+
+    auto const changed_files = std::min(options.changed_files, sources.size());
+
+    for (std::size_t index = 0; index < changed_files; ++index) {
+      auto const& source     = sources[index * sources.size() / changed_files];
+      auto const  filename   = source.filename.generic_u8string();
+      auto const  line_count = static_cast<std::size_t>(std::count(cbegin(source.content), cend(source.content), '\n'));
+
+      diff += fmt::format("diff --git a/{0} b/{0}\nindex 0123456..789abcd 100644\n--- a/{0}\n+++ b/{0}\n", filename);
+
+      auto starts = std::vector<std::size_t>{};
+      for (std::size_t hunk = 0; hunk < options.hunks_per_file and line_count > 0; ++hunk)
+        starts.push_back(generator.between(1, line_count));
+
+      std::sort(begin(starts), end(starts));
+      starts.erase(std::unique(begin(starts), end(starts)), end(starts));
+
+      for (auto const start : starts) {
+        auto const length = std::min<std::size_t>(generator.between(1, 5), line_count - start + 1);
+        diff += fmt::format("@@ -{0},{1} +{0},{1} @@\n", start, length);
+
+        for (std::size_t line = 0; line < length; ++line)
+          diff += "-  removed\n";
+        for (std::size_t line = 0; line < length; ++line)
+          diff += "+  added\n";
+      }
+    }
+
+    return diff;
+  }
+
+  void write(std::filesystem::path const& directory, corpus::options const& options) {
+    auto const sources = make_sources(options);
+
+    std::filesystem::create_directories(directory / "src");
+
+    auto file_list = std::string{};
+    for (auto const& source : sources) {
+      auto const filename = std::filesystem::absolute(directory / source.filename);
+
+      io::replace_content(filename, source.content);
+      file_list += filename.generic_u8string() + '\n';
+    }
+
+    io::replace_content(directory / "sources.txt", file_list);
+    io::replace_content(directory / "changes.diff", make_diff(sources, options));
+  }
+} // namespace generator::corpus
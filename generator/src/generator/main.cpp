@@ -1,24 +1,43 @@
+#include "generator/allocation.h"
+#include "generator/analysis.h"
+#include "generator/baseline.h"
 #include "generator/cli.h"
+#include "generator/compilation.h"
 #include "generator/format.h"
 #include "generator/io.h"
 #include "generator/json.h"
 #include "generator/output.h"
 #include "generator/scm.h"
+#include "generator/shard.h"
+#include "generator/watch.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <optional>
 #include <sstream>
 
 namespace generator {
 
-  auto parse_rules_async(std::filesystem::path const& filename) {
-    return std::async(std::launch::async, [=] { return json::parse_rules(io::content(filename)); });
+  auto parse_rules_async(std::filesystem::path const&                  filename,
+                         std::shared_future<feedback::workflow> const& shared_workflow,
+                         trace::recorder*                              tracer) {
+    return std::async(std::launch::async, [=] {
+      auto const traced  = trace::span{ tracer, "parse rules", filename };
+      auto const phase   = allocation::scope{ allocation::phase::load };
+      auto const content = io::content(filename);
+      return json::parse_rules(content, shared_workflow.get());
+    });
   }
 
-  auto parse_sources_async(std::filesystem::path const& filename) {
+  auto parse_sources_async(std::filesystem::path const& filename, trace::recorder* tracer = nullptr,
+                           shard::selection selected = {}) {
     return std::async(std::launch::async, [=] {
+      auto const traced = trace::span{ tracer, "parse sources", filename };
+      auto const phase  = allocation::scope{ allocation::phase::load };
+
       if (!std::filesystem::exists(filename))
         throw std::invalid_argument{ "file not found" };
 
@@ -30,26 +49,247 @@ namespace generator {
       for (std::string source; std::getline(content, source);)
         sources.emplace_back(source);
 
-      return sources;
+      return shard::select(sources, selected);
+    });
+  }
+
+  auto compilation_selection(cli::parameters const& parameters) {
+    // the build directory holds generated sources, which are skipped like in the file lists of the CMake module
+    auto selection            = compilation::selection{};
+    selection.target          = parameters.compile_commands_target;
+    selection.headers         = parameters.headers_from_depfiles;
+    selection.root            = std::filesystem::current_path();
+    selection.build_directory = std::filesystem::absolute(parameters.compile_commands_filename).parent_path();
+
+    return selection;
+  }
+
+  auto parse_compile_commands_async(cli::parameters const& parameters, trace::recorder* tracer,
+                                    shard::selection selected) {
+    auto const filename  = parameters.compile_commands_filename;
+    auto const selection = compilation_selection(parameters);
+
+    return std::async(std::launch::async, [=] {
+      auto const traced   = trace::span{ tracer, "parse compile commands", filename };
+      auto const phase    = allocation::scope{ allocation::phase::load };
+      auto const commands = compilation::parse_commands(io::content(filename));
+
+      return shard::select(compilation::sources(commands, selection), selected);
     });
   }
 
-  auto parse_workflow_async(std::filesystem::path const& filename) {
+  auto parse_sources_async(cli::parameters const& parameters, trace::recorder* tracer = nullptr,
+                           shard::selection selected = {}) {
+    if (not parameters.compile_commands_filename.empty())
+      return parse_compile_commands_async(parameters, tracer, selected);
+
+    return parse_sources_async(parameters.sources_filename, tracer, selected);
+  }
+
+  // the generated file is rebuilt by the build system whenever the rules, the workflow, one of the sources or one of
+  // the depfiles its headers are read from change
+  void write_depfile(cli::parameters const& parameters, std::vector<std::filesystem::path> const& sources) {
+    auto prerequisites = std::vector<std::filesystem::path>{ std::filesystem::absolute(parameters.rules_filename) };
+    if (not parameters.workflow_filename.empty())
+      prerequisites.push_back(std::filesystem::absolute(parameters.workflow_filename));
+
+    for (auto const& source : sources)
+      prerequisites.push_back(std::filesystem::absolute(source));
+
+    // the headers are read from the depfiles of the compiler, which are missing before its first build
+    if (parameters.headers_from_depfiles) {
+      auto const commands = compilation::parse_commands(io::content(parameters.compile_commands_filename));
+
+      prerequisites.push_back(std::filesystem::absolute(parameters.compile_commands_filename));
+      for (auto const& depfile : compilation::depfiles(commands, compilation_selection(parameters)))
+        prerequisites.push_back(depfile);
+    }
+
+    io::replace_content(parameters.written_depfile_filename,
+                        compilation::to_depfile(std::filesystem::absolute(parameters.output_filename), prerequisites));
+  }
+
+  auto parse_workflow_async(std::filesystem::path const& filename, trace::recorder* tracer) {
     return std::async(std::launch::async, [=] {
+      auto const traced = trace::span{ tracer, "parse workflow", filename };
+      auto const phase  = allocation::scope{ allocation::phase::load };
+
       if (not filename.empty())
         return json::parse_workflow(io::content(filename));
       return feedback::workflow{};
     });
   }
 
-  auto parse_diff_async(std::filesystem::path const& filename) {
+  auto parse_diff_async(std::filesystem::path const&                                  filename,
+                        std::filesystem::path const&                                  index_filename,
+                        std::string const&                                            relevant_changes,
+                        std::shared_future<std::vector<std::filesystem::path>> const& shared_sources,
+                        trace::recorder*                                              tracer) {
     return std::async(std::launch::async, [=] {
+      auto const traced = trace::span{ tracer, "parse diff", filename };
+      auto const phase  = allocation::scope{ allocation::phase::load };
+
       scm::diff accumulated;
-      if (not filename.empty())
+      if (not filename.empty() and not index_filename.empty())
+        accumulated = scm::diff::parse_indexed(filename, index_filename);
+      else if (not filename.empty())
         accumulated = scm::diff::parse(io::content(filename), std::move(accumulated));
+      if (not relevant_changes.empty())
+        accumulated = scm::diff::from_git(relevant_changes, shared_sources.get(), std::move(accumulated));
       return accumulated;
     });
   }
+
+  auto analyze_rules(cli::parameters const& parameters) {
+    auto const rules = json::parse_rules(io::content(parameters.rules_filename));
+
+    auto corpus = std::vector<std::string>{};
+    if (not parameters.sources_filename.empty() or not parameters.compile_commands_filename.empty())
+      for (auto const& source : parse_sources_async(parameters).get())
+        corpus.push_back(io::content(source));
+
+    auto limits          = analysis::thresholds{};
+    limits.memory_budget = parameters.memory_budget;
+
+    if (parameters.max_program_size > 0)
+      limits.max_program_size = parameters.max_program_size;
+
+    if (parameters.min_throughput > 0)
+      limits.min_throughput = parameters.min_throughput;
+
+    auto const costs = analysis::analyze(rules, corpus, limits.memory_budget);
+    analysis::print(std::cout, costs);
+
+    auto const violations = analysis::violations(costs, limits);
+    for (auto const& violation : violations)
+      std::cerr << violation << '\n';
+
+    return violations.empty() ? 0 : 1;
+  }
+
+  auto merge_shards(cli::parameters const& parameters) {
+    auto stats = output::stats{};
+    for (auto const& filename : parameters.merged_stats_filenames)
+      stats.merge(shard::parse_stats(io::content(filename)));
+
+    std::sort(begin(stats.unscanned), end(stats.unscanned));
+
+    auto generated = std::vector<std::string>{};
+    for (auto const& filename : parameters.merged_filenames)
+      generated.push_back(io::content(filename));
+
+    std::cout << shard::merge(generated, parameters.rules_filename, stats);
+    return stats;
+  }
+
+  void write_stats(cli::parameters const& parameters, output::stats const& stats) {
+    if (not parameters.stats_filename.empty())
+      io::replace_content(parameters.stats_filename, shard::to_json(stats));
+
+    if (not parameters.unscanned_filename.empty()) {
+      auto file_list = std::string{};
+      for (auto const& source : stats.unscanned)
+        file_list += source.u8string() + '\n';
+
+      io::replace_content(parameters.unscanned_filename, file_list);
+    }
+  }
+
+  // keeps the rules compiled and the results of all sources in memory, rescans only the changed sources and replaces
+  // the output after each change; changed rules, workflow or file list are reloaded and all sources are rescanned
+  [[noreturn]] void watch_sources(cli::parameters const& parameters, shard::selection selected, output::options options) {
+    auto const listed  = parameters.compile_commands_filename.empty() ? parameters.sources_filename
+                                                                      : parameters.compile_commands_filename;
+    auto configuration = std::vector<std::filesystem::path>{ parameters.rules_filename, listed };
+    if (not parameters.workflow_filename.empty())
+      configuration.push_back(parameters.workflow_filename);
+
+    // a changed diff changes the relevance of all sources, not only of those changed with it
+    for (auto const& filename : { parameters.diff_filename, parameters.diff_index_filename })
+      if (not filename.empty())
+        configuration.push_back(filename);
+
+    // a rule file saved while being edited must not end watching, the next change may fix it
+    auto const reported = [](auto&& action) {
+      try {
+        action();
+      }
+      catch (std::exception const& e) {
+        std::cerr << e.what() << '\n';
+      }
+    };
+
+    auto results = watch::results{ parameters.rules_filename };
+
+    while (true) {
+      auto const shared_workflow = parse_workflow_async(parameters.workflow_filename, nullptr).share();
+      auto const shared_rules    = parse_rules_async(parameters.rules_filename, shared_workflow, nullptr).share();
+      auto const shared_sources  = parse_sources_async(parameters, nullptr, selected).share();
+
+      auto const rescan = [&](std::vector<std::filesystem::path> const& sources) {
+        // invalid rules are reported here, the scan would only find them on its workers
+        shared_rules.get();
+
+        auto const start          = std::chrono::steady_clock::now();
+        auto const shared_scanned = std::async(std::launch::deferred, [=] { return sources; }).share();
+        auto const shared_diff    = parse_diff_async(parameters.diff_filename, parameters.diff_index_filename,
+                                                  parameters.relevant_changes, shared_scanned, nullptr)
+                                 .share();
+
+        // each rescan consumes the findings of its sources from a fresh baseline
+        auto baseline_findings = std::optional<baseline::fingerprints>{};
+        if (not parameters.baseline_filename.empty())
+          options.known_findings = &baseline_findings.emplace(io::content(parameters.baseline_filename));
+
+        if (parameters.time_budget > 0)
+          options.deadline = start + std::chrono::milliseconds{ parameters.time_budget };
+
+        auto       generated = std::ostringstream{};
+        auto const stats     = output::print(generated,
+                                         output::matches{ parameters.rules_filename, shared_rules, shared_scanned, shared_workflow, shared_diff },
+                                         options);
+
+        results.update(generated.str());
+        io::replace_content(parameters.output_filename, results.to_string());
+
+        format::print(std::cerr, "Scanned {} of {} source(s) with {} byte(s) in {} millisecond(s).\n",
+                      stats.sources, sources.size(), stats.bytes,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+      };
+
+      auto sources = std::vector<std::filesystem::path>{};
+      reported([&] { sources = shared_sources.get(); });
+
+      // a stale diff index is rebuilt before watching, otherwise its rebuild by the first scan would reload again
+      if (not parameters.diff_filename.empty() and not parameters.diff_index_filename.empty())
+        reported([&] { scm::diff::parse_indexed(parameters.diff_filename, parameters.diff_index_filename); });
+
+      // watching starts before the first scan, so that no change during it is missed
+      auto watched = configuration;
+      watched.insert(end(watched), cbegin(sources), cend(sources));
+
+      auto changes = watch::watcher{ watched };
+
+      results.clear();
+      reported([&] { rescan(sources); });
+
+      for (auto reload = false; not reload;) {
+        auto rescanned = std::vector<std::filesystem::path>{};
+
+        for (auto const& file : changes.wait(std::chrono::milliseconds{ 20 })) {
+          if (std::find(cbegin(configuration), cend(configuration), file) != cend(configuration))
+            reload = true;
+          else if (std::filesystem::exists(file))
+            rescanned.push_back(file);
+          else
+            results.remove(file);
+        }
+
+        if (not reload)
+          reported([&] { rescan(rescanned); });
+      }
+    }
+  }
 } // namespace generator
 
 void print(std::ostream& out, generator::output::stats stats, std::chrono::nanoseconds duration) {
@@ -57,6 +297,26 @@ void print(std::ostream& out, generator::output::stats stats, std::chrono::nanos
                            stats.bytes, std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
 }
 
+void print_allocations(std::ostream& out) {
+  namespace allocation = generator::allocation;
+
+  auto total  = allocation::counters{};
+  auto phases = std::string{};
+
+  for (std::size_t index = 0; index < allocation::phase_count; ++index) {
+    auto const phase    = static_cast<allocation::phase>(index);
+    auto const counters = allocation::counters_of(phase);
+
+    total.allocations += counters.allocations;
+    total.bytes += counters.bytes;
+    phases += fmt::format("{}{}: {} in {} byte(s)", phases.empty() ? "" : ", ", allocation::name_of(phase),
+                          counters.allocations, counters.bytes);
+  }
+
+  generator::format::print(out, "Allocated {} byte(s) in {} allocation(s) ({}) with a peak RSS of {} byte(s).\n",
+                           total.bytes, total.allocations, phases, allocation::peak_rss());
+}
+
 int main(int argc, char* argv[]) {
   using namespace generator;
 
@@ -66,15 +326,101 @@ int main(int argc, char* argv[]) {
     auto const start      = std::chrono::steady_clock::now();
     auto const parameters = cli::parse(argc, argv);
 
-    auto const shared_rules    = parse_rules_async(parameters.rules_filename).share();
-    auto const shared_sources  = parse_sources_async(parameters.sources_filename).share();
-    auto const shared_workflow = parse_workflow_async(parameters.workflow_filename).share();
-    auto const shared_diff     = parse_diff_async(parameters.diff_filename).share();
+    if (parameters.analyze_rules)
+      return analyze_rules(parameters);
+
+    if (parameters.index_only) {
+      scm::diff::parse_indexed(parameters.diff_filename, parameters.diff_index_filename);
+      return 0;
+    }
+
+    if (not parameters.merged_filenames.empty() or not parameters.merged_stats_filenames.empty()) {
+      auto const stats = merge_shards(parameters);
+
+      write_stats(parameters, stats);
+      print(std::cerr, stats, std::chrono::steady_clock::now() - start);
+      return 0;
+    }
+
+    auto const selected = parameters.shard.empty()
+                          ? shard::selection{}
+                          : shard::parse(parameters.shard, shard::to_partitioning(parameters.shard_by));
+
+    auto profiler = profile::recorder{ parameters.profile_top_count };
+    auto tracer   = trace::recorder{};
+    auto options  = output::options{};
+
+    options.max_findings          = parameters.max_findings;
+    options.max_errors            = parameters.max_errors;
+    options.max_findings_per_rule = parameters.max_findings_per_rule;
+    options.max_findings_per_file = parameters.max_findings_per_file;
+    options.window_size           = parameters.window_size;
+    options.segment_size          = parameters.segment_size;
+    options.scanners              = parameters.scanners;
+    options.read_ahead            = parameters.read_ahead;
+    options.pending_sections      = parameters.pending_sections;
+
+    if (parameters.watch)
+      watch_sources(parameters, selected, options);
+
+    auto known_findings    = std::optional<baseline::fingerprints>{};
+    auto recorded_findings = baseline::fingerprints{};
+
+    if (not parameters.baseline_filename.empty())
+      options.known_findings = &known_findings.emplace(io::content(parameters.baseline_filename));
+
+    if (not parameters.written_baseline_filename.empty())
+      options.recorded_findings = &recorded_findings;
+
+    if (parameters.time_budget > 0)
+      options.deadline = start + std::chrono::milliseconds{ parameters.time_budget };
 
-    auto const stats =
-    print(std::cout, output::matches{ parameters.rules_filename, shared_rules, shared_sources, shared_workflow, shared_diff });
+    if (not parameters.profile_filename.empty())
+      options.profiler = &profiler;
+
+    if (not parameters.trace_filename.empty())
+      options.tracer = &tracer;
+
+    auto const shared_workflow = parse_workflow_async(parameters.workflow_filename, options.tracer).share();
+    auto const shared_rules    = parse_rules_async(parameters.rules_filename, shared_workflow, options.tracer).share();
+    auto const shared_sources  = parse_sources_async(parameters, options.tracer, selected).share();
+    auto const shared_diff     = parse_diff_async(parameters.diff_filename, parameters.diff_index_filename,
+                                              parameters.relevant_changes, shared_sources, options.tracer)
+                             .share();
+
+    auto          generated = std::ostringstream{};
+    std::ostream& out       = parameters.output_filename.empty() ? std::cout : generated;
+    auto const    stats =
+    print(out, output::matches{ parameters.rules_filename, shared_rules, shared_sources, shared_workflow, shared_diff },
+          options);
+
+    if (not parameters.output_filename.empty())
+      io::replace_content(parameters.output_filename, generated.str());
+
+    if (not parameters.written_depfile_filename.empty())
+      write_depfile(parameters, shared_sources.get());
+
+    if (options.profiler)
+      io::replace_content(parameters.profile_filename, profiler.to_json());
+
+    if (options.tracer)
+      io::replace_content(parameters.trace_filename, tracer.to_json());
+
+    if (options.recorded_findings)
+      io::replace_content(parameters.written_baseline_filename, recorded_findings.to_string());
 
     print(std::cerr, stats, std::chrono::steady_clock::now() - start);
+    write_stats(parameters, stats);
+
+    if (not stats.unscanned.empty())
+      format::print(std::cerr, "Left {} source(s) unscanned after the time budget of {} millisecond(s).\n",
+                    stats.unscanned.size(), parameters.time_budget);
+
+    if (not parameters.memory_filename.empty())
+      io::replace_content(parameters.memory_filename, allocation::to_json());
+
+    if (allocation::counting)
+      print_allocations(std::cerr);
   }
   catch (std::exception const& e) {
     std::cerr << e.what() << '\n';
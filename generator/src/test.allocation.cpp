@@ -0,0 +1,95 @@
+#include "catch2/catch.hpp"
+#include "generator/allocation.h"
+#include "generator/json.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+  struct alignas(64) cache_line {
+    std::array<char, 64> bytes;
+  };
+
+  auto difference(generator::allocation::counters const& before, generator::allocation::counters const& after) {
+    return generator::allocation::counters{ after.allocations - before.allocations, after.bytes - before.bytes };
+  }
+} // namespace
+
+SCENARIO("allocation counting", "[allocation]") {
+  using generator::allocation::counters_of;
+  using generator::allocation::phase;
+
+  GIVEN("A scope of a phase") {
+    WHEN("memory is allocated in it, with the default and with an extended alignment") {
+      auto const before    = counters_of(phase::emit);
+      auto       unaligned = std::unique_ptr<std::array<char, 100>>{};
+      auto       aligned   = std::unique_ptr<cache_line>{};
+      {
+        auto const in_phase = generator::allocation::scope{ phase::emit };
+        unaligned           = std::make_unique<std::array<char, 100>>();
+        aligned             = std::make_unique<cache_line>();
+      }
+      auto const counted = difference(before, counters_of(phase::emit));
+
+      THEN("the memory is aligned as requested") {
+        REQUIRE(reinterpret_cast<std::uintptr_t>(aligned.get()) % alignof(cache_line) == 0);
+      }
+      THEN("both allocations are counted for the phase, if counting") {
+        if constexpr (generator::allocation::counting) {
+          REQUIRE(counted.allocations == 2);
+          REQUIRE(counted.bytes == 100 + sizeof(cache_line));
+        }
+        else {
+          REQUIRE(counted.allocations == 0);
+          REQUIRE(counted.bytes == 0);
+        }
+      }
+      THEN("the previous phase is restored at its end") {
+        REQUIRE(generator::allocation::current_phase() == phase::other);
+      }
+    }
+  }
+
+  GIVEN("Rules compiled on the workers of the parallel algorithms") {
+    auto json = std::string{ "{" };
+    for (auto index = 0; index < 64; ++index)
+      json += (index > 0 ? ", " : "") + ("\"RULE" + std::to_string(index)) +
+              R"_(": { "type": "guideline", "summary": "rule", "matched_text": "TODO[0-9]+ (\\w+)" })_";
+    json += "}";
+
+    auto const workflow =
+    generator::json::parse_workflow(R"({ "default": { "check": "everything", "response": "warning" } })");
+
+    // the workers are started before, so that their own allocations are not counted
+    auto warm_up = std::vector<int>(1024);
+    std::iota(begin(warm_up), end(warm_up), 0);
+    std::for_each(std::execution::par, begin(warm_up), end(warm_up), [](int& value) { value *= 2; });
+
+    WHEN("they are parsed in the load phase") {
+      auto const others_before = counters_of(phase::other);
+      auto const loads_before  = counters_of(phase::load);
+      {
+        auto const in_phase = generator::allocation::scope{ phase::load };
+        REQUIRE(generator::json::parse_rules(json, workflow).size() == 64);
+      }
+      auto const others = difference(others_before, counters_of(phase::other));
+      auto const loads  = difference(loads_before, counters_of(phase::load));
+
+      THEN("the allocations of the workers are counted for the load phase, too") {
+        if constexpr (generator::allocation::counting) {
+          REQUIRE(loads.allocations > 64);
+          REQUIRE(others.allocations < 64);
+        }
+        else {
+          REQUIRE(loads.allocations == 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,62 @@
+#include "catch2/catch.hpp"
+#include "generator/analysis.h"
+#include "generator/json.h"
+
+#include <string>
+#include <vector>
+
+SCENARIO("rule analysis", "[analysis]") {
+  auto const workflow =
+  generator::json::parse_workflow(R"({ "default": { "check": "everything", "response": "warning" } })");
+
+  GIVEN("A cheap rule and a rule with a large program") {
+    auto const rules = generator::json::parse_rules(R"({
+      "CHEAP": { "type": "guideline", "summary": "cheap", "matched_text": "TODO" },
+      "LARGE": { "type": "guideline", "summary": "large", "matched_text": "[a-z]{1000}" }
+    })", workflow);
+
+    WHEN("they are analyzed within the default memory budget") {
+      auto limits             = generator::analysis::thresholds{};
+      limits.max_program_size = 100;
+
+      auto const costs = generator::analysis::analyze(rules, {}, limits.memory_budget);
+
+      THEN("only the large one exceeds the program size") {
+        REQUIRE(costs.size() == 2);
+        REQUIRE(costs[0].matched_text.program_size <= 100);
+        REQUIRE(costs[1].matched_text.program_size > 100);
+        REQUIRE(generator::analysis::violations(costs, limits) ==
+                std::vector<std::string>{ "LARGE: program size " + std::to_string(costs[1].matched_text.program_size) +
+                                          " exceeds 100" });
+      }
+      THEN("neither is measured without a corpus") {
+        REQUIRE(not costs[0].throughput);
+        REQUIRE(not costs[1].throughput);
+      }
+    }
+
+    WHEN("they are analyzed with a memory budget too small for the large one") {
+      auto limits          = generator::analysis::thresholds{};
+      limits.memory_budget = 2 << 10;
+
+      auto const costs = generator::analysis::analyze(rules, {}, limits.memory_budget);
+
+      THEN("only the large one violates it") {
+        REQUIRE(generator::analysis::violations(costs, limits) ==
+                std::vector<std::string>{ "LARGE: matched_text exceeds the memory budget of 2048 byte(s)" });
+      }
+    }
+
+    WHEN("they are measured on a corpus against an unreachable throughput") {
+      auto limits           = generator::analysis::thresholds{};
+      limits.min_throughput = 1e12;
+
+      auto const costs = generator::analysis::analyze(rules, { std::string(1024, 'x') }, limits.memory_budget);
+
+      THEN("both are too slow") {
+        REQUIRE(costs[0].throughput);
+        REQUIRE(generator::analysis::violations(costs, limits).size() == 2);
+      }
+    }
+  }
+}
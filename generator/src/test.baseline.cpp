@@ -0,0 +1,42 @@
+#include "catch2/catch.hpp"
+#include "generator/baseline.h"
+
+SCENARIO("baseline usage", "[baseline]") {
+  using namespace generator::baseline;
+
+  GIVEN("Matched lines which differ only in whitespace") {
+    THEN("their content hashes are equal") {
+      REQUIRE(content_hash("  int  x;\t// TODO\r\n") == content_hash("int x; // TODO"));
+    }
+    THEN("other content has another hash") {
+      REQUIRE(content_hash("int x; // TODO") != content_hash("int y; // TODO"));
+    }
+  }
+
+  GIVEN("A baseline with a finding recorded twice") {
+    auto const finding  = fingerprint{ "RULE1", "src/file.cpp", content_hash("\tint x;") };
+    auto       recorded = fingerprints{};
+
+    recorded.add(finding);
+    recorded.add(finding);
+
+    WHEN("it is written and read again") {
+      auto known = fingerprints{ recorded.to_string() };
+
+      THEN("both occurrences are known, but not a third one") {
+        REQUIRE(known.consume(finding));
+        REQUIRE(known.consume(finding));
+        REQUIRE(not known.consume(finding));
+      }
+      THEN("findings in other files are new") {
+        REQUIRE(not known.consume(fingerprint{ "RULE1", "src/other.cpp", finding.content }));
+      }
+    }
+  }
+
+  GIVEN("A corrupted baseline") {
+    THEN("it is rejected") {
+      REQUIRE_THROWS_AS(fingerprints{ "RULE1\tsrc/file.cpp\tnot a hash\n" }, std::invalid_argument);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#include "catch2/catch.hpp"
+#include "generator/compilation.h"
+#include "generator/io.h"
+
+#include <filesystem>
+#include <string>
+
+SCENARIO("compilation database usage", "[compilation]") {
+  GIVEN("A compilation database with commands and arguments") {
+    auto const commands = generator::compilation::parse_commands(R"([
+      { "directory": "/build", "file": "../src/a.cpp",
+        "command": "c++ -I\"/include dir\" -MD -MT a.o -MF 'CMakeFiles/lib.dir/a.cpp.o.d' -o CMakeFiles/lib.dir/a.cpp.o -c ../src/a.cpp" },
+      { "directory": "/build", "file": "/src/b.cpp",
+        "arguments": [ "c++", "-MMD", "-o", "CMakeFiles/app.dir/b.cpp.o", "-c", "/src/b.cpp" ] },
+      { "directory": "/build", "file": "/src/c.cpp", "output": "CMakeFiles/app.dir/c.cpp.o",
+        "arguments": [ "c++", "-c", "/src/c.cpp" ] }
+    ])");
+
+    THEN("the paths are absolute") {
+      REQUIRE(commands.size() == 3);
+      REQUIRE(commands[0].file == "/src/a.cpp");
+      REQUIRE(commands[0].output == "/build/CMakeFiles/lib.dir/a.cpp.o");
+      REQUIRE(commands[2].output == "/build/CMakeFiles/app.dir/c.cpp.o");
+    }
+    THEN("a command is split like a shell") {
+      REQUIRE(commands[0].arguments.size() == 11);
+      REQUIRE(commands[0].arguments[1] == "-I/include dir");
+      REQUIRE(commands[0].arguments[6] == "CMakeFiles/lib.dir/a.cpp.o.d");
+    }
+    THEN("the depfiles are found") {
+      REQUIRE(generator::compilation::depfile_of(commands[0]) == "/build/CMakeFiles/lib.dir/a.cpp.o.d");
+      REQUIRE(generator::compilation::depfile_of(commands[1]) == "/build/CMakeFiles/app.dir/b.cpp.d");
+      REQUIRE(not generator::compilation::depfile_of(commands[2]));
+    }
+    THEN("the sources of a target are selected") {
+      auto selected   = generator::compilation::selection{};
+      selected.target = "app";
+
+      auto const sources = generator::compilation::sources(commands, selected);
+
+      REQUIRE(sources == std::vector<std::filesystem::path>{ "/src/b.cpp", "/src/c.cpp" });
+    }
+    THEN("the depfiles of a target are listed before the compiler writes them") {
+      auto selected   = generator::compilation::selection{};
+      selected.target = "app";
+
+      auto const depfiles = generator::compilation::depfiles(commands, selected);
+
+      REQUIRE(depfiles == std::vector<std::filesystem::path>{ "/build/CMakeFiles/app.dir/b.cpp.d" });
+    }
+  }
+
+  GIVEN("A depfile written by a compiler") {
+    auto const depfile = std::string{ "CMakeFiles/lib.dir/a.cpp.o: \\\n"
+                                      "  /src/a.cpp /src/with\\ space.h \\\r\n"
+                                      "  C:\\include\\c.h \\\n"
+                                      "  /src/dollar$$.h\n"
+                                      "/src/with\\ space.h:\n" };
+
+    THEN("the prerequisites are parsed") {
+      auto const prerequisites = generator::compilation::parse_depfile(depfile);
+
+      REQUIRE(prerequisites == std::vector<std::filesystem::path>{ "/src/a.cpp", "/src/with space.h", "C:\\include\\c.h",
+                                                                   "/src/dollar$.h" });
+    }
+    THEN("a written one is parsed again") {
+      auto const prerequisites = std::vector<std::filesystem::path>{ "/src/with space.h", "/src/dollar$.h", "/src/#.h" };
+      auto const written       = generator::compilation::to_depfile("/build/feedback.cpp", prerequisites);
+
+      REQUIRE(generator::compilation::parse_depfile(written) == prerequisites);
+    }
+  }
+
+  GIVEN("A build with depfiles") {
+    auto const root  = std::filesystem::temp_directory_path() / "generator.test.compilation";
+    auto const build = root / "build";
+    std::filesystem::create_directories(build / "CMakeFiles" / "lib.dir");
+
+    generator::io::replace_content(root / "a.cpp", "#include \"a.h\"\n");
+    generator::io::replace_content(build / "CMakeFiles" / "lib.dir" / "a.cpp.d",
+                                   "CMakeFiles/lib.dir/a.cpp.o: ../a.cpp ../a.h generated.h /usr/include/cstdio\n");
+
+    auto const commands = generator::compilation::parse_commands(
+    R"([ { "directory": ")" + build.generic_u8string() + R"(", "file": "../a.cpp", "output": "CMakeFiles/lib.dir/a.cpp.o",
+           "arguments": [ "c++", "-MD", "-c", "../a.cpp" ] } ])");
+
+    auto selected            = generator::compilation::selection{};
+    selected.root            = root;
+    selected.build_directory = build;
+
+    WHEN("headers are not requested") {
+      THEN("only the sources are selected") {
+        REQUIRE(generator::compilation::sources(commands, selected) == std::vector<std::filesystem::path>{ root / "a.cpp" });
+      }
+    }
+    WHEN("headers are requested") {
+      selected.headers = true;
+
+      THEN("the headers inside the root and outside of the build directory are added") {
+        REQUIRE(generator::compilation::sources(commands, selected) ==
+                std::vector<std::filesystem::path>{ root / "a.cpp", root / "a.h" });
+      }
+    }
+
+    std::filesystem::remove_all(root);
+  }
+}
@@ -2,6 +2,10 @@
 
 #include "catch2/catch.hpp"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 SCENARIO("interval map usage", "[container]") {
   GIVEN("An interval map from integers to booleans") {
     auto const map = generator::container::interval_map<int, bool>{ false };
@@ -17,3 +21,51 @@ SCENARIO("interval map usage", "[container]") {
     }
   }
 }
+
+SCENARIO("bounded queue usage", "[container]") {
+  GIVEN("A bounded queue of two items") {
+    auto queue = generator::container::bounded_queue<int>{ 2 };
+
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+
+    WHEN("it is closed") {
+      queue.close();
+
+      THEN("no item is added") {
+        REQUIRE(not queue.push(3));
+      }
+      THEN("the remaining items are taken in order") {
+        REQUIRE(queue.pop() == 1);
+        REQUIRE(queue.pop() == 2);
+        REQUIRE(not queue.pop());
+      }
+    }
+    WHEN("a producer adds more items than fit") {
+      auto producer = std::thread{ [&] {
+        for (auto item = 3; item <= 100; ++item)
+          queue.push(item);
+
+        queue.close();
+      } };
+
+      auto taken = std::vector<int>{};
+      while (auto item = queue.pop())
+        taken.push_back(*item);
+
+      producer.join();
+
+      THEN("all of them are taken in order") {
+        REQUIRE(taken.size() == 100);
+        REQUIRE(std::is_sorted(begin(taken), end(taken)));
+      }
+      THEN("the queue never held more than its capacity") {
+        auto const counters = queue.counters();
+
+        REQUIRE(counters.capacity == 2);
+        REQUIRE(counters.peak == 2);
+        REQUIRE(counters.pushed == 100);
+      }
+    }
+  }
+}
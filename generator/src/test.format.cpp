@@ -0,0 +1,48 @@
+#include "catch2/catch.hpp"
+#include "generator/format.h"
+
+#include <string>
+
+namespace {
+  auto escaped(std::string_view text) {
+    return fmt::format("{}", generator::format::as_compiler_message{ text });
+  }
+} // namespace
+
+SCENARIO("compiler message escaping", "[format]") {
+  GIVEN("Text without special characters") {
+    auto const text = std::string(100, 'x');
+
+    THEN("it is copied unchanged") {
+      REQUIRE(escaped(text) == text);
+    }
+  }
+
+  GIVEN("Text with quotes and backslashes") {
+    THEN("they are escaped") {
+      REQUIRE(escaped(R"(say "C:\tmp")") == R"(say \"C:\\tmp\")");
+    }
+  }
+
+  GIVEN("Text with line breaks") {
+    THEN("each following line is indented") {
+      REQUIRE(escaped("first\r\nsecond\nthird") == R"(first\n      | second\n      | third)");
+    }
+    THEN("a trailing line break is not indented") {
+      REQUIRE(escaped("line\n") == R"(line\n)");
+    }
+    THEN("empty lines are indented as well") {
+      REQUIRE(escaped("\n\n") == R"(\n      | \n)");
+    }
+  }
+
+  GIVEN("Special characters beyond the first block of 16 characters") {
+    auto text = std::string(40, 'x');
+    text[17]  = '"';
+    text[35]  = '\n';
+
+    THEN("all of them are found") {
+      REQUIRE(escaped(text) == std::string(17, 'x') + R"(\")" + std::string(17, 'x') + R"(\n      | )" + std::string(4, 'x'));
+    }
+  }
+}
@@ -0,0 +1,121 @@
+#include "catch2/catch.hpp"
+#include "generator/format.h"
+#include "generator/io.h"
+#include "generator/regex.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+SCENARIO("chunk writer usage", "[io]") {
+  GIVEN("An output stream") {
+    std::ostringstream out;
+
+    AND_GIVEN("a chunk writer on it") {
+      auto writer = generator::io::chunk_writer{ out };
+
+      WHEN("chunks are submitted") {
+        for (auto index = 0; index < 100; ++index) {
+          auto chunk = writer.acquire();
+          generator::format::print(chunk, "{};", index);
+          writer.submit(std::move(chunk));
+        }
+
+        AND_WHEN("the writer is flushed") {
+          writer.flush();
+
+          THEN("all chunks are written in the order of submission") {
+            auto expected = std::string{};
+            for (auto index = 0; index < 100; ++index)
+              expected += std::to_string(index) + ';';
+
+            REQUIRE(out.str() == expected);
+          }
+          THEN("written chunks are recycled empty") {
+            REQUIRE(writer.acquire().size() == 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("window reader usage", "[io]") {
+  GIVEN("A file with numbered lines") {
+    auto const filename = std::filesystem::temp_directory_path() / "generator.test.windows.txt";
+
+    auto content = std::string{};
+    for (auto line = 1; line <= 100; ++line)
+      content += "line " + std::to_string(line) + (line % 10 == 0 ? " begin\nend\n" : "\n");
+
+    generator::io::replace_content(filename, content);
+
+    WHEN("it is read in small windows") {
+      auto reader  = generator::io::window_reader{ filename, 64 };
+      auto own     = std::string{};
+      auto windows = std::vector<generator::text::window>{};
+      auto texts   = std::vector<std::string>{};
+
+      while (auto const window = reader.next()) {
+        own.append(window->text.substr(0, window->own_length));
+        windows.push_back(*window);
+        texts.emplace_back(window->text);
+      }
+
+      THEN("the own parts of all windows are whole lines of the file") {
+        REQUIRE(windows.size() > 1);
+        REQUIRE(own == content);
+
+        for (auto const& window : windows) {
+          REQUIRE(window.own_length <= 64);
+          REQUIRE(content.substr(window.offset, window.own_length).back() == '\n');
+          REQUIRE(window.preceding_lines == std::count(content.data(), content.data() + window.offset, '\n'));
+        }
+      }
+      THEN("each window overlaps into the next one") {
+        for (std::size_t index = 0; index + 1 < windows.size(); ++index)
+          REQUIRE(texts[index].substr(windows[index].own_length) ==
+                  content.substr(windows[index + 1].offset, texts[index].length() - windows[index].own_length));
+      }
+    }
+
+    WHEN("a two line pattern is searched window by window") {
+      auto const pattern = generator::regex::capture("begin\nend");
+      auto       reader  = generator::io::window_reader{ filename, 64 };
+      auto       lines   = std::vector<int>{};
+
+      while (auto const window = reader.next()) {
+        auto search = generator::text::forward_search{ window->text, window->context, window->preceding_lines };
+
+        while (search.next(pattern) and search.matched_text().data() < window->text.data() + window->own_length)
+          lines.push_back(search.line());
+      }
+
+      THEN("matches across window boundaries are found on their lines") {
+        auto expected = std::vector<int>{};
+        for (auto match = 1; match <= 10; ++match)
+          expected.push_back(11 * match - 1);
+
+        REQUIRE(lines == expected);
+      }
+    }
+
+    WHEN("a pattern anchored to the beginning of the file is searched window by window") {
+      auto const pattern = generator::regex::capture("^line [0-9]+");
+      auto       reader  = generator::io::window_reader{ filename, 64 };
+      auto       count   = 0;
+
+      while (auto const window = reader.next()) {
+        auto search = generator::text::forward_search{ window->text, window->context, window->preceding_lines };
+        while (search.next(pattern))
+          ++count;
+      }
+
+      THEN("it matches only at the beginning of the file") {
+        REQUIRE(count == 1);
+      }
+    }
+
+    std::filesystem::remove(filename);
+  }
+}
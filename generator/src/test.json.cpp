@@ -0,0 +1,101 @@
+#include "catch2/catch.hpp"
+#include "generator/json.h"
+
+SCENARIO("rules parsing", "[json]") {
+  GIVEN("Rules with an invalid pattern in a disabled rule") {
+    auto const rules = R"({
+      "ENABLED": { "type": "requirement", "summary": "enabled", "matched_text": "x" },
+      "DISABLED": { "type": "suggestion", "summary": "disabled", "matched_text": "(" }
+    })";
+
+    WHEN("they are parsed without a workflow") {
+      THEN("the invalid pattern is reported") {
+        REQUIRE_THROWS_WITH(generator::json::parse_rules(rules), Catch::Contains("DISABLED"));
+      }
+    }
+
+    WHEN("they are parsed with a workflow which disables the rule") {
+      auto const workflow =
+      generator::json::parse_workflow(R"({ "suggestion": { "check": "nothing" }, "default": { "check": "everything" } })");
+      auto const parsed = generator::json::parse_rules(rules, workflow);
+
+      THEN("only the enabled rule is compiled") {
+        REQUIRE(parsed.size() == 1);
+        REQUIRE(parsed.count("ENABLED") == 1);
+      }
+    }
+
+    WHEN("they are parsed with a workflow which mutes the rule") {
+      auto const workflow = generator::json::parse_workflow(R"({ "suggestion": { "response": "none" } })");
+
+      THEN("the disabled rule is skipped") {
+        REQUIRE(generator::json::parse_rules(rules, workflow).count("DISABLED") == 0);
+      }
+    }
+  }
+
+  GIVEN("Rules with several invalid patterns") {
+    auto const rules = R"({
+      "C": { "type": "requirement", "summary": "c", "matched_text": "[" },
+      "A": { "type": "requirement", "summary": "a", "matched_text": "(" },
+      "B": { "type": "requirement", "summary": "b", "matched_text": "x" }
+    })";
+
+    THEN("the first invalid rule is reported deterministically") {
+      for (auto i = 0; i < 10; ++i)
+        REQUIRE_THROWS_WITH(generator::json::parse_rules(rules), Catch::StartsWith("rule A:"));
+    }
+  }
+
+  GIVEN("Rules with scopes") {
+    auto const rules = R"({
+      "ANY": { "type": "requirement", "summary": "any", "matched_text": "x" },
+      "CODE": { "type": "requirement", "summary": "code", "matched_text": "x", "scope": "code" },
+      "TEXT": { "type": "requirement", "summary": "text", "matched_text": "x", "scope": [ "comment", "string" ] }
+    })";
+
+    WHEN("they are parsed") {
+      auto const parsed = generator::json::parse_rules(rules);
+
+      THEN("the scopes are combined into regions") {
+        REQUIRE(parsed.at("ANY").scope == generator::lexer::any);
+        REQUIRE(parsed.at("CODE").scope == generator::lexer::code);
+        REQUIRE(parsed.at("TEXT").scope == (generator::lexer::comment | generator::lexer::string));
+      }
+    }
+
+    AND_GIVEN("an unknown scope") {
+      auto const invalid = R"({ "BAD": { "type": "requirement", "summary": "bad", "matched_text": "x", "scope": "codes" } })";
+
+      THEN("it is reported") {
+        REQUIRE_THROWS_WITH(generator::json::parse_rules(invalid), Catch::Contains("unknown scope: codes"));
+      }
+    }
+  }
+
+  GIVEN("Rules with engines") {
+    auto const rules = R"({
+      "REGEX": { "type": "requirement", "summary": "regex", "matched_text": "\t" },
+      "BUILTIN": { "type": "requirement", "summary": "builtin", "engine": "builtin:tab" }
+    })";
+
+    WHEN("they are parsed") {
+      auto const parsed = generator::json::parse_rules(rules);
+
+      THEN("a builtin kernel needs no matched text") {
+        auto found = generator::regex::match{};
+
+        REQUIRE(parsed.at("BUILTIN").matched_text.find("a\tb", &found, nullptr, nullptr));
+        REQUIRE(found == "\t");
+      }
+    }
+
+    AND_GIVEN("an unknown engine") {
+      auto const invalid = R"({ "BAD": { "type": "requirement", "summary": "bad", "engine": "builtin:tabs" } })";
+
+      THEN("it is reported") {
+        REQUIRE_THROWS_WITH(generator::json::parse_rules(invalid), Catch::Contains("unknown builtin engine: tabs"));
+      }
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#include "catch2/catch.hpp"
+#include "generator/regex.h"
+#include "generator/text.h"
+
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+  auto all_matches(std::string_view text, generator::regex::precompiled const& pattern) {
+    auto found  = std::vector<std::tuple<int, int, std::string>>{};
+    auto search = generator::text::forward_search{ text };
+
+    while (search.next(pattern))
+      found.emplace_back(search.line(), search.column(), search.matched_text());
+
+    return found;
+  }
+
+  constexpr auto long_line =
+  std::string_view{ "  auto const greeting = \"gr\xc3\xbc\xc3\x9f dich\"; // a comment which makes this line too long" };
+
+  auto const text = "int main() {\r\n\treturn 0; \t\n" + std::string{ long_line } + "\n  \n}  ";
+} // namespace
+
+SCENARIO("builtin kernels", "[kernel]") {
+  GIVEN("A text with tabs, trailing whitespace, CRLF line endings, non-ASCII bytes and a long line") {
+    WHEN("each kernel searches it") {
+      THEN("it finds the same as the equivalent regex") {
+        REQUIRE(all_matches(text, generator::regex::builtin("tab")) == all_matches(text, generator::regex::capture("\t")));
+        REQUIRE(all_matches(text, generator::regex::builtin("non_ascii")) ==
+                all_matches(text, generator::regex::capture("[^\\x00-\\x7f]+")));
+      }
+      THEN("it finds the bytes of a line beyond its maximum length") {
+        using found = std::vector<std::tuple<int, int, std::string>>;
+
+        REQUIRE(all_matches(text, generator::regex::builtin("long_line:40")) ==
+                found{ { 3, 41, std::string{ long_line.substr(40) } } });
+        REQUIRE(all_matches(text, generator::regex::builtin("long_line:200")).empty());
+      }
+      THEN("it finds the line endings and the whitespace before them") {
+        using found = std::vector<std::tuple<int, int, std::string>>;
+
+        REQUIRE(all_matches(text, generator::regex::builtin("crlf")) == found{ { 1, 13, "\r" } });
+        REQUIRE(all_matches(text, generator::regex::builtin("trailing_whitespace")) ==
+                found{ { 2, 11, " \t" }, { 4, 1, "  " }, { 5, 2, "  " } });
+      }
+    }
+
+    WHEN("a kernel searches a part of it") {
+      auto const context = std::string_view{ text };
+      auto const part    = context.substr(context.find("greeting"));
+      auto const line    = context.find(long_line);
+
+      THEN("it measures lines from their start in the context") {
+        auto found = generator::regex::match{};
+        REQUIRE(generator::regex::builtin("long_line:40").find(part, context, &found, nullptr, nullptr));
+        REQUIRE(found.data() == context.data() + line + 40);
+      }
+    }
+  }
+
+  GIVEN("Unknown or invalid kernel names") {
+    THEN("they are rejected") {
+      REQUIRE_THROWS_AS(generator::regex::builtin("tabs"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::regex::builtin("long_line"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::regex::builtin("long_line:x"), std::invalid_argument);
+    }
+  }
+}
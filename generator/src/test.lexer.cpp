@@ -0,0 +1,50 @@
+#include "catch2/catch.hpp"
+#include "generator/lexer.h"
+
+#include <string_view>
+
+namespace {
+  auto region_of(std::string_view source, std::string_view token) {
+    return generator::lexer::mask{ source }[source.find(token)];
+  }
+} // namespace
+
+SCENARIO("lexical masking", "[lexer]") {
+  using namespace generator;
+
+  GIVEN("A C++ source") {
+    auto const source = std::string_view{ R"(#include <dir//file.h>  // include comment
+#define MACRO(x) \
+  continued(x) /* macro comment */
+auto text = "string // not a comment";
+auto raw  = R"delimiter(raw " string)delimiter";
+auto ch   = '"'; // after a character literal
+auto num  = 0x1'FF'AB; int separated;
+/* block
+   comment */ auto code = 1;
+)" };
+
+    THEN("each token is in its region") {
+      REQUIRE(region_of(source, "dir//file.h") == lexer::preprocessor);
+      REQUIRE(region_of(source, "include comment") == lexer::comment);
+      REQUIRE(region_of(source, "continued") == lexer::preprocessor);
+      REQUIRE(region_of(source, "macro comment") == lexer::comment);
+      REQUIRE(region_of(source, "auto text") == lexer::code);
+      REQUIRE(region_of(source, "// not a comment") == lexer::string);
+      REQUIRE(region_of(source, "raw \" string") == lexer::string);
+      REQUIRE(region_of(source, ";\nauto ch") == lexer::code);
+      REQUIRE(region_of(source, "after a character") == lexer::comment);
+      REQUIRE(region_of(source, "int separated") == lexer::code);
+      REQUIRE(region_of(source, "   comment") == lexer::comment);
+      REQUIRE(region_of(source, "auto code") == lexer::code);
+    }
+  }
+
+  GIVEN("Scope names") {
+    THEN("they map to regions") {
+      REQUIRE(lexer::to_regions("code") == lexer::code);
+      REQUIRE(lexer::to_regions("any") == lexer::any);
+      REQUIRE_THROWS_AS(lexer::to_regions("whitespace"), std::invalid_argument);
+    }
+  }
+}
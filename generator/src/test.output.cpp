@@ -0,0 +1,420 @@
+#include "catch2/catch.hpp"
+#include "generator/io.h"
+#include "generator/json.h"
+#include "generator/output.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+  template <class T> auto ready(T value) {
+    auto promise = std::promise<T>{};
+    promise.set_value(std::move(value));
+    return promise.get_future().share();
+  }
+
+  auto count(std::string const& text, std::string const& part) {
+    auto found = std::size_t{ 0 };
+    for (auto offset = text.find(part); offset != std::string::npos; offset = text.find(part, offset + part.length()))
+      ++found;
+
+    return found;
+  }
+
+  auto lines(std::string const& text) {
+    return static_cast<std::size_t>(std::count(begin(text), end(text), '\n'));
+  }
+
+  // generates the feedback of the rules for the sources, which have no changes unless a diff is given
+  auto generate_with_stats(std::string_view workflow_json, std::string_view rules_json,
+                           std::vector<std::filesystem::path> const& sources, generator::output::options const& options,
+                           generator::scm::diff diff = {}) {
+    auto const rules_origin    = std::filesystem::path{ "rules.json" };
+    auto const shared_workflow = ready(generator::json::parse_workflow(workflow_json));
+    auto const shared_rules    = ready(generator::json::parse_rules(rules_json, shared_workflow.get()));
+    auto const shared_sources  = ready(sources);
+    auto const shared_diff     = ready(std::move(diff));
+
+    auto       generated = std::ostringstream{};
+    auto const stats     = generator::output::print(
+    generated, generator::output::matches{ rules_origin, shared_rules, shared_sources, shared_workflow, shared_diff }, options);
+
+    return std::pair{ generated.str(), stats };
+  }
+
+  auto generate(std::string_view workflow_json, std::string_view rules_json,
+                std::vector<std::filesystem::path> const& sources, generator::output::options const& options,
+                generator::scm::diff diff = {}) {
+    return generate_with_stats(workflow_json, rules_json, sources, options, std::move(diff)).first;
+  }
+} // namespace
+
+SCENARIO("baseline relevance", "[output]") {
+  GIVEN("A workflow which checks only changes and a source with findings, but no changes") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.output.baseline";
+    auto const source    = directory / "a.cpp";
+    std::filesystem::create_directories(directory);
+    generator::io::replace_content(source, "int x;\t// first\nint y;\t// second\n");
+
+    auto const workflow = R"({
+      "requirement": { "check": "changed_files", "response": "error" },
+      "default": { "check": "changed_lines", "response": "warning" }
+    })";
+    auto const rules    = R"({
+      "TAB": { "type": "requirement", "summary": "tab", "matched_text": "\t" },
+      "INT": { "type": "guideline", "summary": "int", "matched_text": "int" }
+    })";
+
+    WHEN("it is scanned without a baseline") {
+      auto const generated = generate(workflow, rules, { source }, {});
+
+      THEN("nothing is reported") {
+        REQUIRE(count(generated, "MESSAGE(\"") == 0);
+      }
+    }
+
+    WHEN("a baseline is written") {
+      auto recorded             = generator::baseline::fingerprints{};
+      auto options              = generator::output::options{};
+      options.recorded_findings = &recorded;
+
+      generate(workflow, rules, { source }, options);
+
+      THEN("the findings of all lines are recorded") {
+        REQUIRE(lines(recorded.to_string()) == 4);
+      }
+    }
+
+    WHEN("it is compared against a baseline with some of its findings") {
+      auto known = generator::baseline::fingerprints{};
+      known.add({ "TAB", source.lexically_proximate(std::filesystem::current_path()).generic_u8string(),
+                  generator::baseline::content_hash("int x;\t// first") });
+
+      auto options           = generator::output::options{};
+      options.known_findings = &known;
+
+      auto const generated = generate(workflow, rules, { source }, options);
+
+      THEN("only the findings missing in the baseline are reported") {
+        REQUIRE(count(generated, "MESSAGE(\"") == 3);
+        REQUIRE(count(generated, "\n# line 2\n") == 2);
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+}
+
+SCENARIO("prioritized scanning", "[output]") {
+  GIVEN("A large and a small unchanged source and a changed one") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.output.prioritized";
+    auto const large     = directory / "large.cpp";
+    auto const small     = directory / "small.cpp";
+    auto const changed   = directory / "changed.cpp";
+    std::filesystem::create_directories(directory);
+    generator::io::replace_content(large, std::string(4096, ' ') + "// TODO\n");
+    generator::io::replace_content(small, "// TODO\n");
+    generator::io::replace_content(changed, std::string(8192, ' ') + "// TODO\n");
+
+    auto const workflow = R"({ "default": { "check": "everything", "response": "warning" } })";
+    auto const rules    = R"({ "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO" } })";
+
+    WHEN("they are scanned with a deadline by a single scanner, which writes them in the order it starts them") {
+      auto options     = generator::output::options{};
+      options.deadline = std::chrono::steady_clock::now() + std::chrono::hours{ 1 };
+      options.scanners = 1;
+
+      auto const generated =
+      generate(workflow, rules, { large, small, changed }, options, generator::scm::diff::parse_untracked("changed.cpp"));
+
+      auto const started = [&](std::filesystem::path const& source) {
+        return generated.find("#line 1 \"" + source.generic_u8string() + "\"");
+      };
+
+      THEN("the changed source is started first and then the others from small to large") {
+        REQUIRE(started(large) != std::string::npos);
+        REQUIRE(started(changed) < started(small));
+        REQUIRE(started(small) < started(large));
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+}
+
+SCENARIO("windowed scanning", "[output]") {
+  GIVEN("A rule with a scope") {
+    auto const workflow = R"({ "default": { "check": "everything", "response": "warning" } })";
+    auto const rules    = R"({ "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO", "scope": "comment" } })";
+
+    WHEN("sources are scanned in windows") {
+      auto options        = generator::output::options{};
+      options.window_size = 4096;
+
+      THEN("it is rejected, since a window may start inside a comment") {
+        REQUIRE_THROWS_AS(generate(workflow, rules, {}, options), std::invalid_argument);
+      }
+    }
+  }
+}
+
+SCENARIO("finding budget", "[output]") {
+  GIVEN("A source with three findings of a warning and an error") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.output.budget";
+    auto const source    = directory / "a.cpp";
+    std::filesystem::create_directories(directory);
+    generator::io::replace_content(source, "// TODO\n// TODO\n// TODO\n");
+
+    auto const workflow = R"({
+      "requirement": { "check": "everything", "response": "error" },
+      "default": { "check": "everything", "response": "warning" }
+    })";
+    auto const warnings = R"({ "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO" } })";
+    auto const errors   = R"({ "TODO": { "type": "requirement", "summary": "todo", "matched_text": "TODO" } })";
+
+    WHEN("the limit of findings equals their number") {
+      auto options         = generator::output::options{};
+      options.max_findings = 3;
+
+      auto const generated = generate(workflow, warnings, { source }, options);
+
+      THEN("all are reported without a note") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 3);
+        REQUIRE(count(generated, "suppressed") == 0);
+      }
+    }
+
+    WHEN("the limit of findings is below their number") {
+      auto options         = generator::output::options{};
+      options.max_findings = 2;
+
+      auto const generated = generate(workflow, warnings, { source }, options);
+
+      THEN("the findings up to the limit are reported with a note") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 2);
+        REQUIRE(count(generated, "MESSAGE(\"note further findings suppressed after reaching --max-findings=2\")") == 1);
+      }
+    }
+
+    WHEN("the limit of errors is below their number") {
+      auto options       = generator::output::options{};
+      options.max_errors = 1;
+
+      auto const generated = generate(workflow, errors, { source }, options);
+
+      THEN("the errors up to the limit are reported with a note") {
+        REQUIRE(count(generated, "MESSAGE(\"error ") == 1);
+        REQUIRE(count(generated, "MESSAGE(\"note further findings suppressed after reaching --max-errors=1\")") == 1);
+      }
+    }
+
+    WHEN("the limit of errors is reached in the first of several sources") {
+      auto const later   = directory / "b.cpp";
+      auto const clean   = directory / "c.cpp";
+      generator::io::replace_content(later, "// TODO\n");
+      generator::io::replace_content(clean, "// done\n");
+
+      auto options       = generator::output::options{};
+      options.max_errors = 1;
+      options.scanners   = 1;
+
+      auto const [generated, stats] = generate_with_stats(workflow, errors, { source, later, clean }, options);
+
+      THEN("the later sources are not scanned") {
+        REQUIRE(stats.sources == 1);
+        REQUIRE(count(generated, "#line 1 \"" + later.generic_u8string()) == 0);
+        REQUIRE(count(generated, "MESSAGE(\"error ") == 1);
+      }
+    }
+
+    WHEN("the limit of errors is reached by the last finding of a source before others") {
+      auto const clean = directory / "b.cpp";
+      generator::io::replace_content(source, "// TODO\n");
+      generator::io::replace_content(clean, "// done\n");
+
+      auto options       = generator::output::options{};
+      options.max_errors = 1;
+      options.scanners   = 1;
+
+      auto const [generated, stats] = generate_with_stats(workflow, errors, { source, clean }, options);
+
+      THEN("the remaining sources are not scanned, which the note tells instead of suppressed findings") {
+        REQUIRE(stats.sources == 1);
+        REQUIRE(count(generated, "suppressed") == 0);
+        REQUIRE(count(generated, "MESSAGE(\"note remaining sources and rules not scanned after reaching --max-errors=1\")") == 1);
+      }
+    }
+
+    WHEN("the limit of errors is above their number") {
+      auto options       = generator::output::options{};
+      options.max_errors = 4;
+
+      auto const generated = generate(workflow, errors, { source }, options);
+
+      THEN("all are reported without a note") {
+        REQUIRE(count(generated, "MESSAGE(\"error ") == 3);
+        REQUIRE(count(generated, "suppressed") == 0);
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+}
+
+SCENARIO("finding caps", "[output]") {
+  GIVEN("A source with four lines with findings of two rules each") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.output.caps";
+    auto const source    = directory / "a.cpp";
+    std::filesystem::create_directories(directory);
+    generator::io::replace_content(source, "// TODO FIXME\n// TODO FIXME\n// TODO FIXME\n// TODO FIXME\n");
+
+    auto const workflow = R"({ "default": { "check": "everything", "response": "warning" } })";
+    auto const rules    = R"({
+      "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO" },
+      "FIXME": { "type": "guideline", "summary": "fixme", "matched_text": "FIXME", "max_findings_per_file": 1 }
+    })";
+    auto const uncapped = R"({
+      "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO" },
+      "FIXME": { "type": "guideline", "summary": "fixme", "matched_text": "FIXME" }
+    })";
+
+    WHEN("the findings per rule are limited") {
+      auto options                  = generator::output::options{};
+      options.max_findings_per_rule = 2;
+
+      auto const generated = generate(workflow, uncapped, { source }, options);
+
+      THEN("each rule reports up to the limit and a note summarizing the others at the first of them") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 4);
+        REQUIRE(count(generated, "MESSAGE(\"note TODO: and 2 more finding(s) in lines 3-4, suppressed after 2 in this source\")") == 1);
+        REQUIRE(count(generated, "MESSAGE(\"note FIXME: and 2 more finding(s) in lines 3-4, suppressed after 2 in this source\")") == 1);
+        REQUIRE(count(generated, "\n# line 3\nMESSAGE(\"note ") == 2);
+      }
+    }
+
+    WHEN("the findings per rule are limited and a rule sets its own limit") {
+      auto options                  = generator::output::options{};
+      options.max_findings_per_rule = 3;
+
+      auto const generated = generate(workflow, rules, { source }, options);
+
+      THEN("the limit of the rule overrides the one of the run") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 4);
+        REQUIRE(count(generated, "MESSAGE(\"note TODO: and 1 more finding(s) in line 4, suppressed after 3 in this source\")") == 1);
+        REQUIRE(count(generated, "MESSAGE(\"note FIXME: and 3 more finding(s) in lines 2-4, suppressed after 1 in this source\")") == 1);
+      }
+    }
+
+    WHEN("the findings per file are limited") {
+      auto options                  = generator::output::options{};
+      options.max_findings_per_file = 3;
+
+      auto const generated = generate(workflow, uncapped, { source }, options);
+
+      THEN("all rules together report up to the limit and a single note summarizing the others") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 3);
+        REQUIRE(count(generated, "MESSAGE(\"note and 5 more finding(s) in lines ") == 1);
+        REQUIRE(count(generated, "-4, suppressed after reaching --max-findings-per-file=3\")") == 1);
+      }
+    }
+
+    WHEN("the source is scanned in windows with the findings per rule limited") {
+      auto options                  = generator::output::options{};
+      options.max_findings_per_rule = 2;
+      options.window_size           = 16;
+
+      auto const generated = generate(workflow, uncapped, { source }, options);
+
+      THEN("the limits and the summaries span all windows") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 4);
+        REQUIRE(count(generated, "MESSAGE(\"note TODO: and 2 more finding(s) in lines 3-4, suppressed after 2 in this source\")") == 1);
+        REQUIRE(count(generated, "MESSAGE(\"note FIXME: and 2 more finding(s) in lines 3-4, suppressed after 2 in this source\")") == 1);
+      }
+    }
+
+    WHEN("a rule has far more findings than its limit") {
+      auto const legacy = directory / "legacy.cpp";
+      auto       lines  = std::string{};
+      for (auto line = 0; line < 1000; ++line)
+        lines += "// TODO\n";
+      generator::io::replace_content(legacy, lines);
+
+      auto options                  = generator::output::options{};
+      options.max_findings_per_rule = 10;
+
+      auto const generated = generate(workflow, uncapped, { legacy }, options);
+
+      THEN("the others are counted, but only summarized") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 10);
+        REQUIRE(count(generated, "MESSAGE(\"note TODO: and 990 more finding(s) in lines 11-1000, suppressed after 10 in this source\")") == 1);
+        REQUIRE(count(generated, "MESSAGE(\"note ") == 1);
+      }
+    }
+
+    WHEN("the findings of the run are limited below those per file") {
+      auto options                  = generator::output::options{};
+      options.max_findings          = 2;
+      options.max_findings_per_file = 4;
+
+      auto const generated = generate(workflow, uncapped, { source }, options);
+
+      THEN("the findings rejected by the run don't count in the source") {
+        REQUIRE(count(generated, "MESSAGE(\"warning ") == 2);
+        REQUIRE(count(generated, "--max-findings-per-file") == 0);
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+}
+
+SCENARIO("profiled scanning", "[output]") {
+  GIVEN("A source with findings of two rules") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.output.profile";
+    auto const source    = directory / "a.cpp";
+    std::filesystem::create_directories(directory);
+    generator::io::replace_content(source, "// TODO FIXME\n// TODO\n");
+
+    auto const workflow = R"({ "default": { "check": "everything", "response": "warning" } })";
+    auto const rules    = R"({
+      "TODO": { "type": "guideline", "summary": "todo", "matched_text": "TODO" },
+      "FIXME": { "type": "guideline", "summary": "fixme", "matched_text": "FIXME" }
+    })";
+
+    WHEN("it is scanned with a profiler") {
+      auto profiler    = generator::profile::recorder{};
+      auto options     = generator::output::options{};
+      options.profiler = &profiler;
+
+      generate(workflow, rules, { source }, options);
+
+      auto const profile = nlohmann::json::parse(profiler.to_json());
+
+      THEN("the summed time of the rules is split into scanning and emitting the source") {
+        auto const& file = profile["files"][0];
+        auto const  rule_milliseconds =
+        profile["rules"]["TODO"]["milliseconds"].get<double>() + profile["rules"]["FIXME"]["milliseconds"].get<double>();
+
+        REQUIRE(profile["rules"]["TODO"]["matches"] == 2);
+        REQUIRE(file["read_milliseconds"].get<double>() > 0.0);
+        REQUIRE(file["rule_scan_milliseconds"].get<double>() > 0.0);
+        REQUIRE(file["rule_emit_milliseconds"].get<double>() > 0.0);
+        REQUIRE(file["rule_scan_milliseconds"].get<double>() + file["rule_emit_milliseconds"].get<double>() ==
+                Approx(rule_milliseconds));
+      }
+      THEN("the wall time of scanning the source is measured around all of its rules") {
+        REQUIRE(profile["files"][0]["scan_milliseconds"].get<double>() > 0.0);
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+}
@@ -0,0 +1,87 @@
+#include "catch2/catch.hpp"
+#include "generator/profile.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+
+SCENARIO("profile recording", "[profile]") {
+  using namespace std::chrono_literals;
+  using generator::profile::file_timings;
+  using generator::profile::rule_counters;
+
+  GIVEN("A recorder of the two slowest rules in sources") {
+    auto recorder = generator::profile::recorder{ 2 };
+
+    WHEN("a rule is recorded in several sources") {
+      recorder.record("RULE1", "a.cpp", rule_counters{ 1, 100, 3, 1, 2ms });
+      recorder.record("RULE1", "b.cpp", rule_counters{ 1, 50, 1, 0, 1ms });
+
+      auto const profile = nlohmann::json::parse(recorder.to_json());
+
+      THEN("its counters are summed up") {
+        auto const& rule = profile["rules"]["RULE1"];
+
+        REQUIRE(rule["files"] == 2);
+        REQUIRE(rule["bytes"] == 150);
+        REQUIRE(rule["matches"] == 4);
+        REQUIRE(rule["ignored_matches"] == 1);
+        REQUIRE(rule["milliseconds"].get<double>() == Approx(3.0));
+      }
+    }
+
+    WHEN("more rules in sources are recorded than it keeps") {
+      recorder.record("RULE1", "a.cpp", rule_counters{ 1, 1, 0, 0, 2ms });
+      recorder.record("RULE2", "a.cpp", rule_counters{ 1, 1, 0, 0, 5ms });
+      recorder.record("RULE3", "a.cpp", rule_counters{ 1, 1, 0, 0, 1ms });
+      recorder.record("RULE1", "b.cpp", rule_counters{ 1, 1, 0, 0, 3ms });
+
+      auto const profile = nlohmann::json::parse(recorder.to_json());
+
+      THEN("the slowest ones are kept from slowest to fastest") {
+        auto const& slowest = profile["slowest"];
+
+        REQUIRE(slowest.size() == 2);
+        REQUIRE(slowest[0]["rule"] == "RULE2");
+        REQUIRE(slowest[1]["rule"] == "RULE1");
+        REQUIRE(slowest[1]["source"] == "b.cpp");
+      }
+      THEN("all of them count for their rules") {
+        REQUIRE(profile["rules"].size() == 3);
+        REQUIRE(profile["rules"]["RULE1"]["milliseconds"].get<double>() == Approx(5.0));
+      }
+    }
+
+    WHEN("the timings of a source are recorded in parts") {
+      recorder.record("b.cpp", file_timings{ 1ms, 0ms, 0ms, 0ms });
+      recorder.record("a.cpp", file_timings{ 0ms, 4ms, 4ms, 0ms });
+      recorder.record("b.cpp", file_timings{ 0ms, 4ms, 2ms, 3ms });
+
+      auto const profile = nlohmann::json::parse(recorder.to_json());
+
+      THEN("they are summed up per source, sorted by source") {
+        auto const& files = profile["files"];
+
+        REQUIRE(files.size() == 2);
+        REQUIRE(files[0]["source"] == "a.cpp");
+        REQUIRE(files[1]["source"] == "b.cpp");
+        REQUIRE(files[1]["read_milliseconds"].get<double>() == Approx(1.0));
+        REQUIRE(files[1]["scan_milliseconds"].get<double>() == Approx(4.0));
+        REQUIRE(files[1]["rule_scan_milliseconds"].get<double>() == Approx(2.0));
+        REQUIRE(files[1]["rule_emit_milliseconds"].get<double>() == Approx(3.0));
+      }
+    }
+  }
+
+  GIVEN("A recorder which keeps no slowest rules") {
+    auto recorder = generator::profile::recorder{ 0 };
+    recorder.record("RULE1", "a.cpp", rule_counters{ 1, 1, 0, 0, 2ms });
+
+    THEN("the rules are recorded nevertheless") {
+      auto const profile = nlohmann::json::parse(recorder.to_json());
+
+      REQUIRE(profile["slowest"].empty());
+      REQUIRE(profile["rules"]["RULE1"]["files"] == 1);
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include "catch2/catch.hpp"
 #include "generator/regex.h"
 
+#include <string_view>
+
 SCENARIO("regex tests", "[regex]") {
   GIVEN("A pattern which matches any character") {
     auto const any_character_pattern = ".";
@@ -86,4 +88,54 @@ second line
       }
     }
   }
+
+  GIVEN("An anchored pattern with a literal and a pattern which matches anything") {
+    auto const literal_pattern  = generator::regex::capture("^ *#include");
+    auto const anything_pattern = generator::regex::capture(".*");
+
+    WHEN("their costs are analyzed") {
+      auto const default_budget = std::int64_t{ 8 << 20 };
+
+      auto const literal_cost  = literal_pattern.cost(default_budget);
+      auto const anything_cost = anything_pattern.cost(default_budget);
+
+      THEN("only the first one is anchored and has a required literal") {
+        REQUIRE(literal_cost.anchored);
+        REQUIRE(literal_cost.required_literal);
+        REQUIRE(not anything_cost.anchored);
+        REQUIRE(not anything_cost.required_literal);
+      }
+      THEN("both fit into the default budget") {
+        REQUIRE(literal_cost.within_budget);
+        REQUIRE(anything_cost.within_budget);
+        REQUIRE(literal_cost.program_size > 0);
+      }
+      THEN("they exceed a tiny budget") {
+        REQUIRE(not literal_pattern.cost(100).within_budget);
+      }
+    }
+  }
+
+  GIVEN("Patterns anchored in some or all of their alternatives") {
+    auto const anchored = [](std::string_view pattern) {
+      return generator::regex::compile(pattern).cost(std::int64_t{ 8 << 20 }).anchored;
+    };
+
+    THEN("only those anchored in all alternatives are anchored") {
+      REQUIRE(anchored("^a|^b"));
+      REQUIRE(anchored("(^a|\\Ab)c|^d"));
+      REQUIRE(not anchored("^a|b"));
+      REQUIRE(not anchored("(^a|b)c"));
+      REQUIRE(not anchored("[(^]a"));
+    }
+    THEN("groups and flags before the anchor are skipped") {
+      REQUIRE(anchored("(?i)^a"));
+      REQUIRE(anchored("(?:^a)"));
+      REQUIRE(anchored("(?P<name>(?s:^a))|(?m)^b"));
+    }
+    THEN("an optional group anchors nothing") {
+      REQUIRE(not anchored("(^a)?b"));
+      REQUIRE(not anchored("(?:^a)*b"));
+    }
+  }
 }
@@ -0,0 +1,72 @@
+#include "catch2/catch.hpp"
+#include "generator/json.h"
+#include "generator/scan.h"
+
+#include <future>
+#include <string>
+
+SCENARIO("in-memory scanning", "[scan]") {
+  GIVEN("Compiled rules and unsaved buffers") {
+    auto const workflow = generator::json::parse_workflow(R"({
+      "requirement": { "check": "everything", "response": "error" },
+      "guideline": { "check": "changed_lines", "response": "warning" }
+    })");
+    auto const rules    = generator::json::parse_rules(R"({
+      "TODO": { "type": "requirement", "summary": "todo", "matched_text": "TODO", "scope": "comment" },
+      "GOTO": { "type": "guideline", "summary": "goto", "matched_text": "goto", "matched_files": "[.]cpp$" }
+    })",
+                                                    workflow);
+
+    auto const content = std::string{ "// TODO\nauto const todo = \"TODO\";\ngoto end;\ngoto end;\n" };
+
+    WHEN("a buffer is scanned without changes") {
+      auto const found = generator::scan::find(rules, workflow, generator::scan::buffer{ "unsaved.cpp", content, {} });
+
+      THEN("the findings of all lines are sorted by line and column") {
+        REQUIRE(found.size() == 3);
+        REQUIRE(found[0].rule == "TODO");
+        REQUIRE(found[0].line == 1);
+        REQUIRE(found[0].column == 4);
+        REQUIRE(std::holds_alternative<generator::feedback::error>(found[0].response));
+        REQUIRE(found[1].rule == "GOTO");
+        REQUIRE(found[1].line == 3);
+        REQUIRE(found[1].matched_lines == "goto end;");
+        REQUIRE(found[2].line == 4);
+      }
+    }
+
+    WHEN("a buffer is scanned with changed lines") {
+      auto const changes = generator::scm::diff::changes::lines(4, 4);
+      auto const found   = generator::scan::find(rules, workflow, generator::scan::buffer{ "unsaved.cpp", content, changes });
+
+      THEN("rules which check changed lines report only those") {
+        REQUIRE(found.size() == 2);
+        REQUIRE(found[0].rule == "TODO");
+        REQUIRE(found[1].line == 4);
+      }
+    }
+
+    WHEN("several buffers are scanned") {
+      auto const buffers = std::vector<generator::scan::buffer>{ { "b.cpp", content, {} }, { "a.h", content, {} } };
+      auto const found   = generator::scan::find(rules, workflow, buffers);
+
+      THEN("the rules apply by path and the findings are sorted by source") {
+        REQUIRE(found.size() == 4);
+        REQUIRE(found[0].source == "a.h");
+        REQUIRE(found[1].source == "b.cpp");
+      }
+    }
+
+    WHEN("the buffers are scanned concurrently") {
+      auto const scan = [&] { return generator::scan::find(rules, workflow, { "unsaved.cpp", content, {} }).size(); };
+
+      auto first  = std::async(std::launch::async, scan);
+      auto second = std::async(std::launch::async, scan);
+
+      THEN("each call finds the same") {
+        REQUIRE(first.get() == 3);
+        REQUIRE(second.get() == 3);
+      }
+    }
+  }
+}
@@ -0,0 +1,139 @@
+#include "catch2/catch.hpp"
+#include "generator/io.h"
+#include "generator/scm.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+SCENARIO("scm diff usage", "[scm]") {
+  GIVEN("A diff with a modified line") {
+    auto const output = R"(diff --git a/src/modified.cpp b/src/modified.cpp
+index 0123456..789abcd 100644
+--- a/src/modified.cpp
++++ b/src/modified.cpp
+@@ -2 +2 @@ int main()
+-  return 1;
++  return 0;
+)";
+
+    WHEN("it is parsed") {
+      auto const diff = generator::scm::diff::parse(output);
+
+      THEN("only the modified line is changed") {
+        auto const changes = diff.changes_from("/home/user/project/src/modified.cpp");
+
+        REQUIRE(not changes.empty());
+        REQUIRE(not changes[1]);
+        REQUIRE(changes[2]);
+        REQUIRE(not changes[3]);
+      }
+      THEN("other files are unchanged") {
+        REQUIRE(diff.changes_from("/home/user/project/src/other.cpp").empty());
+      }
+    }
+  }
+
+  GIVEN("A NUL separated list of untracked files") {
+    auto const file_list = std::string_view{ "src/first.cpp\0src/second.cpp\0", 30 };
+
+    WHEN("it is parsed") {
+      auto const diff = generator::scm::diff::parse_untracked(file_list);
+
+      THEN("all lines of all untracked files are changed") {
+        for (auto const source : { "/home/user/project/src/first.cpp", "/home/user/project/src/second.cpp" }) {
+          auto const changes = diff.changes_from(source);
+
+          REQUIRE(not changes.empty());
+          REQUIRE(changes[1]);
+          REQUIRE(changes[100000]);
+        }
+      }
+      THEN("tracked files are unchanged") {
+        REQUIRE(diff.changes_from("/home/user/project/src/third.cpp").empty());
+      }
+    }
+  }
+
+  GIVEN("A parsed diff with modified and untracked files") {
+    auto const output = R"(diff --git a/src/modified.cpp b/src/modified.cpp
+index 0123456..789abcd 100644
+--- a/src/modified.cpp
++++ b/src/modified.cpp
+@@ -2,0 +3,2 @@ int main()
++  auto x = 0;
++  auto y = 0;
+)";
+    auto const diff = generator::scm::diff::parse_untracked("src/untracked.cpp", generator::scm::diff::parse(output));
+
+    WHEN("it is converted to an index") {
+      auto const stamp = std::uint64_t{ 42 };
+      auto const index = diff.to_index(stamp);
+
+      THEN("the index restores the same changes") {
+        auto const indexed = generator::scm::diff::from_index(index, stamp);
+        REQUIRE(indexed);
+
+        auto const modified = indexed->changes_from("/project/src/modified.cpp");
+        REQUIRE(not modified[2]);
+        REQUIRE(modified[3]);
+        REQUIRE(modified[4]);
+        REQUIRE(not modified[5]);
+
+        auto const untracked = indexed->changes_from("/project/src/untracked.cpp");
+        REQUIRE(untracked[1]);
+        REQUIRE(untracked[100000]);
+      }
+      THEN("a stale index is rejected") {
+        REQUIRE(not generator::scm::diff::from_index(index, stamp + 1));
+      }
+      THEN("a corrupted index is rejected") {
+        auto corrupted = index;
+        corrupted.back() ^= 1;
+
+        REQUIRE(not generator::scm::diff::from_index(corrupted, stamp));
+        REQUIRE(not generator::scm::diff::from_index(index.substr(0, index.size() / 2), stamp));
+      }
+    }
+  }
+
+#ifndef _WIN32
+  GIVEN("A repository with changes in more sources than fit into a single git command") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.scm";
+    auto const previous  = std::filesystem::current_path();
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    generator::io::replace_content("listed.cpp", "int i;\n");
+    generator::io::replace_content("unlisted.cpp", "int j;\n");
+    std::system("git init -q . && git add . && git -c user.name=test -c user.email=test commit -q -m initial");
+    generator::io::replace_content("listed.cpp", "int k;\n");
+    generator::io::replace_content("unlisted.cpp", "int l;\n");
+    generator::io::replace_content("untracked.cpp", "int m;\n");
+
+    // sources missing in the repository, whose paths exceed the length of a command line together
+    auto sources = std::vector<std::filesystem::path>{};
+    for (auto index = 0; index < 2000; ++index)
+      sources.push_back("missing/" + std::string(100, 'x') + std::to_string(index) + ".cpp");
+    sources.push_back("listed.cpp");
+    sources.push_back("untracked.cpp");
+
+    WHEN("the changes of the sources are read from git") {
+      auto const diff = generator::scm::diff::from_git("modified", sources, {});
+
+      THEN("all batches of the sources are read") {
+        REQUIRE(diff.changes_from(directory / "listed.cpp")[1]);
+        REQUIRE(diff.changes_from(directory / "untracked.cpp")[1]);
+      }
+      THEN("git is still restricted to the sources") {
+        REQUIRE(diff.changes_from(directory / "unlisted.cpp").empty());
+      }
+    }
+
+    std::filesystem::current_path(previous);
+    std::filesystem::remove_all(directory);
+  }
+#endif
+}
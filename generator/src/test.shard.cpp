@@ -0,0 +1,162 @@
+#include "catch2/catch.hpp"
+#include "generator/io.h"
+#include "generator/shard.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+  auto all_shards(std::vector<std::filesystem::path> const& sources, generator::shard::partitioning by, std::size_t count) {
+    auto shards = std::vector<std::vector<std::filesystem::path>>{};
+    for (auto index = std::size_t{ 1 }; index <= count; ++index)
+      shards.push_back(generator::shard::select(sources, { index, count, by }));
+
+    return shards;
+  }
+
+  auto sorted(std::vector<std::filesystem::path> sources) {
+    std::sort(begin(sources), end(sources));
+    return sources;
+  }
+
+  auto all_of(std::vector<std::vector<std::filesystem::path>> const& shards) {
+    auto sources = std::vector<std::filesystem::path>{};
+    for (auto const& shard : shards)
+      sources.insert(end(sources), begin(shard), end(shard));
+
+    return sorted(sources);
+  }
+
+  auto total_size(std::vector<std::filesystem::path> const& sources) {
+    auto total = std::uintmax_t{ 0 };
+    for (auto const& source : sources)
+      total += std::filesystem::file_size(source);
+
+    return total;
+  }
+} // namespace
+
+SCENARIO("shard usage", "[shard]") {
+  GIVEN("A shard parameter") {
+    THEN("a valid one is parsed") {
+      auto const selected = generator::shard::parse("2/3", generator::shard::partitioning::size);
+
+      REQUIRE(selected.index == 2);
+      REQUIRE(selected.count == 3);
+      REQUIRE(selected.by == generator::shard::partitioning::size);
+    }
+    THEN("an invalid one is rejected") {
+      REQUIRE_THROWS_AS(generator::shard::parse("0/3"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::shard::parse("4/3"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::shard::parse("1-3"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::shard::parse("x/3"), std::invalid_argument);
+      REQUIRE_THROWS_AS(generator::shard::to_partitioning("random"), std::invalid_argument);
+    }
+  }
+
+  GIVEN("Sources of different sizes") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.shard";
+    std::filesystem::create_directories(directory);
+
+    auto sources = std::vector<std::filesystem::path>{};
+    for (auto index = 1; index <= 40; ++index) {
+      sources.push_back(directory / ("source" + std::to_string(index) + ".cpp"));
+      generator::io::replace_content(sources.back(), std::string(static_cast<std::size_t>(index * 100), 'x'));
+    }
+
+    WHEN("they are partitioned into shards by hash") {
+      auto const shards = all_shards(sources, generator::shard::partitioning::hash, 3);
+
+      THEN("each source belongs to exactly one shard") {
+        REQUIRE(all_of(shards) == sorted(sources));
+      }
+      THEN("the partitioning is deterministic") {
+        REQUIRE(shards == all_shards(sources, generator::shard::partitioning::hash, 3));
+      }
+    }
+
+    WHEN("they are partitioned by size") {
+      auto const shards = all_shards(sources, generator::shard::partitioning::size, 3);
+
+      THEN("each source belongs to exactly one shard") {
+        REQUIRE(all_of(shards) == sorted(sources));
+      }
+      THEN("the shards are balanced within the size of the largest source") {
+        auto sizes = std::vector<std::uintmax_t>{};
+        for (auto const& shard : shards)
+          sizes.push_back(total_size(shard));
+
+        REQUIRE(*std::max_element(begin(sizes), end(sizes)) - *std::min_element(begin(sizes), end(sizes)) <= 4000);
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+
+  GIVEN("The stats of a shard") {
+    auto stats      = generator::output::stats{};
+    stats.sources   = 3;
+    stats.bytes     = 42;
+    stats.unscanned = { "src/late.cpp" };
+
+    stats.suppressed_after    = "--max-errors=1";
+    stats.stopped_after       = "--max-findings=10";
+    stats.read_queue.capacity = 8;
+    stats.read_queue.peak     = 8;
+    stats.read_queue.blocked  = 5;
+
+    WHEN("they are converted to JSON and back") {
+      auto const parsed = generator::shard::parse_stats(generator::shard::to_json(stats));
+
+      THEN("they are the same") {
+        REQUIRE(parsed.sources == stats.sources);
+        REQUIRE(parsed.bytes == stats.bytes);
+        REQUIRE(parsed.unscanned == stats.unscanned);
+        REQUIRE(parsed.suppressed_after == stats.suppressed_after);
+        REQUIRE(parsed.stopped_after == stats.stopped_after);
+        REQUIRE(parsed.read_queue.capacity == stats.read_queue.capacity);
+        REQUIRE(parsed.read_queue.peak == stats.read_queue.peak);
+        REQUIRE(parsed.read_queue.blocked == stats.read_queue.blocked);
+        REQUIRE(parsed.section_queue.pushed == 0);
+      }
+    }
+  }
+
+  GIVEN("The generated files of two shards") {
+    auto const first  = std::string{ "// header\n\n#line 1 \"b.cpp\"\nfinding b\n\n#line 1 \"d.cpp\"\n" };
+    auto const second = std::string{ "// header\n\n#line 1 \"c.cpp\"\n\n#line 1 \"a.cpp\"\nfinding a\n" };
+
+    WHEN("they are merged") {
+      auto const merged = generator::shard::merge({ first, second }, "rules.json", {});
+
+      THEN("the merged file has a single header and all sources in order") {
+        REQUIRE(merged == "// header\n\n#line 1 \"a.cpp\"\nfinding a\n\n#line 1 \"b.cpp\"\nfinding b\n\n#line 1 "
+                          "\"c.cpp\"\n\n#line 1 \"d.cpp\"\n");
+      }
+      THEN("the order of the shards doesn't matter") {
+        REQUIRE(merged == generator::shard::merge({ second, first }, "rules.json", {}));
+      }
+    }
+  }
+
+  GIVEN("The generated files of two shards which both end with notes") {
+    auto const first  = std::string{ "// header\n\n#line 1 \"b.cpp\"\nfinding b\n\n#line 1 \"rules.json\"\nnote of first\n" };
+    auto const second = std::string{ "// header\n\n#line 1 \"a.cpp\"\nfinding a\n\n#line 1 \"rules.json\"\nnote of second\n" };
+
+    auto stats             = generator::output::stats{};
+    stats.unscanned        = { "c.cpp", "d.cpp" };
+    stats.suppressed_after = "--max-findings=10";
+
+    WHEN("they are merged") {
+      auto const merged = generator::shard::merge({ first, second }, "rules.json", stats);
+
+      THEN("the notes of the shards are replaced by those of the merged stats") {
+        REQUIRE(merged == "// header\n\n#line 1 \"a.cpp\"\nfinding a\n\n#line 1 \"b.cpp\"\nfinding b\n" +
+                          generator::output::notes("rules.json", stats));
+        REQUIRE(merged.find("2 source(s) left unscanned") != std::string::npos);
+        REQUIRE(merged.find("after reaching --max-findings=10") != std::string::npos);
+      }
+    }
+  }
+}
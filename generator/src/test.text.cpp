@@ -0,0 +1,61 @@
+#include "catch2/catch.hpp"
+#include "generator/regex.h"
+#include "generator/text.h"
+
+#include <algorithm>
+#include <string>
+
+SCENARIO("text split usage", "[text]") {
+  GIVEN("A text with numbered lines") {
+    auto text = std::string{};
+    for (auto line = 1; line <= 1000; ++line)
+      text += "line " + std::to_string(line) + (line % 100 == 0 ? " begin\nend\n" : "\n");
+
+    WHEN("it is split into segments") {
+      auto const segments = generator::text::split(text, 256);
+
+      THEN("the segments are whole lines of the text in order") {
+        REQUIRE(segments.size() > 1);
+
+        auto offset = std::size_t{ 0 };
+        for (auto const& segment : segments) {
+          REQUIRE(segment.offset == offset);
+          REQUIRE(segment.own_length <= 256);
+          REQUIRE(segment.context == text);
+          REQUIRE(text[offset + segment.own_length - 1] == '\n');
+          REQUIRE(segment.preceding_lines == std::count(text.data(), text.data() + offset, '\n'));
+
+          offset += segment.own_length;
+        }
+
+        REQUIRE(offset == text.length());
+      }
+      THEN("a two line pattern is found on its lines in the segment it starts in") {
+        auto const pattern = generator::regex::capture("begin\nend");
+        auto       lines   = std::vector<int>{};
+
+        for (auto const& segment : segments) {
+          auto search = generator::text::forward_search{ segment.text, segment.context, segment.preceding_lines };
+          while (search.next(pattern) and search.matched_text().data() < segment.text.data() + segment.own_length)
+            lines.push_back(search.line());
+        }
+
+        auto expected = std::vector<int>{};
+        for (auto match = 1; match <= 10; ++match)
+          expected.push_back(101 * match - 1);
+
+        REQUIRE(lines == expected);
+      }
+    }
+
+    WHEN("it is split into segments larger than itself") {
+      auto const segments = generator::text::split(text, text.length());
+
+      THEN("it remains whole") {
+        REQUIRE(segments.size() == 1);
+        REQUIRE(segments.front().text == text);
+        REQUIRE(segments.front().own_length == text.length());
+      }
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include "catch2/catch.hpp"
+#include "generator/allocation.h"
+#include "generator/trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+
+SCENARIO("trace recording", "[trace]") {
+  GIVEN("A recorder") {
+    auto recorder = generator::trace::recorder{};
+
+    WHEN("spans are recorded on two threads") {
+      {
+        auto const traced = generator::trace::span{ &recorder, "read", std::filesystem::path{ "src/a.cpp" } };
+      }
+      std::thread{ [&] { auto const traced = generator::trace::span{ &recorder, "scan" }; } }.join();
+
+      auto const trace  = nlohmann::json::parse(recorder.to_json());
+      auto const events = trace["traceEvents"];
+
+      THEN("they are complete events with a start and a duration") {
+        REQUIRE(events.size() == 2);
+
+        for (auto const& event : events) {
+          REQUIRE(event["ph"] == "X");
+          REQUIRE(event["ts"].get<double>() >= 0.0);
+          REQUIRE(event["dur"].get<double>() >= 0.0);
+        }
+      }
+      THEN("each thread has its own id") {
+        REQUIRE(events[0]["tid"] != events[1]["tid"]);
+      }
+      THEN("the detail is passed as an argument") {
+        REQUIRE(events[0]["name"] == "read");
+        REQUIRE(events[0]["args"]["detail"] == "src/a.cpp");
+        REQUIRE(not events[1].contains("args"));
+      }
+    }
+
+    WHEN("a span without a recorder ends") {
+      auto const long_path = std::filesystem::path{ std::string(256, 'a') + ".cpp" };
+      auto const before    = generator::allocation::counters_of(generator::allocation::phase::read);
+      {
+        auto const in_phase = generator::allocation::scope{ generator::allocation::phase::read };
+        auto const traced   = generator::trace::span{ nullptr, "read", long_path };
+      }
+      auto const after = generator::allocation::counters_of(generator::allocation::phase::read);
+
+      THEN("nothing is recorded") {
+        REQUIRE(nlohmann::json::parse(recorder.to_json())["traceEvents"].empty());
+      }
+      THEN("its detail is not even built") {
+        REQUIRE(after.allocations == before.allocations);
+      }
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "catch2/catch.hpp"
+#include "generator/io.h"
+#include "generator/watch.h"
+
+#include <future>
+#include <string>
+
+SCENARIO("watch usage", "[watch]") {
+  GIVEN("The results of a watched run") {
+    auto results = generator::watch::results{ "rules.json" };
+    results.update("// header\n\n#line 1 \"a.cpp\"\nfinding a\n\n#line 1 \"b.cpp\"\nfinding b\n\n#line 1 \"rules.json\"\nnote\n");
+
+    WHEN("a source is rescanned") {
+      results.update("// header\n\n#line 1 \"b.cpp\"\nfinding c\n");
+
+      THEN("only its section and the notes are replaced") {
+        REQUIRE(results.to_string() == "// header\n\n#line 1 \"a.cpp\"\nfinding a\n\n#line 1 \"b.cpp\"\nfinding c\n");
+      }
+    }
+    WHEN("a source is removed") {
+      results.remove("a.cpp");
+
+      THEN("its section is dropped") {
+        REQUIRE(results.to_string() == "// header\n\n#line 1 \"b.cpp\"\nfinding b\n\n#line 1 \"rules.json\"\nnote\n");
+      }
+    }
+  }
+
+#ifdef __linux__
+  GIVEN("Watched files") {
+    auto const directory = std::filesystem::temp_directory_path() / "generator.test.watch";
+    std::filesystem::create_directories(directory);
+
+    auto const watched   = directory / "watched.cpp";
+    auto const unwatched = directory / "unwatched.cpp";
+    generator::io::replace_content(watched, "int i;\n");
+
+    auto changes = generator::watch::watcher{ { watched } };
+
+    WHEN("they are replaced") {
+      generator::io::replace_content(unwatched, "int j;\n");
+      generator::io::replace_content(watched, "int k;\n");
+
+      THEN("only their changes are reported") {
+        REQUIRE(changes.wait(std::chrono::milliseconds{ 10 }) == std::vector<std::filesystem::path>{ watched });
+      }
+    }
+    WHEN("more changes happen than the kernel queues") {
+      auto const queued = std::stoul(generator::io::content("/proc/sys/fs/inotify/max_queued_events"));
+      for (auto index = 0ul; index < queued / 2; ++index)
+        generator::io::replace_content(unwatched, "int j;\n");
+
+      THEN("all of them are reported, as any of them may have changed") {
+        REQUIRE(changes.wait(std::chrono::milliseconds{ 10 }) == std::vector<std::filesystem::path>{ watched });
+      }
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+#endif
+}
@@ -2,6 +2,8 @@ cmake_policy (VERSION 3.15)
 
 include (FeedbackPrivate)
 
+option (FEEDBACK_USE_COMPILE_COMMANDS "Let the generator collect the sources of feedback targets from compile_commands.json and the depfiles of the previous build instead of collecting them at configure time." OFF)
+
 if (TARGET modules_loaded)
   target_sources (modules_loaded INTERFACE "${CMAKE_CURRENT_LIST_DIR}/Feedback.cmake")
 endif ()
@@ -103,7 +105,7 @@ function (Feedback_GroupTargets)
 endfunction ()
 
 function (Feedback_Add name)
-  cmake_parse_arguments (parameter "" "RULES;WORKFLOW;RELEVANT_CHANGES" "" ${ARGN})
+  cmake_parse_arguments (parameter "" "RULES;WORKFLOW;RELEVANT_CHANGES;BASELINE" "" ${ARGN})
 
   if (NOT DEFINED parameter_RULES)
     message (FATAL_ERROR "No rules given.")
@@ -130,12 +132,16 @@ function (Feedback_Add name)
   get_filename_component (parameter_RULES "${parameter_RULES}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
   get_filename_component (parameter_WORKFLOW "${parameter_WORKFLOW}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
 
+  if (DEFINED parameter_BASELINE)
+    get_filename_component (parameter_BASELINE "${parameter_BASELINE}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+  endif ()
+
   message (STATUS "Adding feedback: ${name}")
-  ConfigureFeedbackTargetFromTargets ("${name}" "${parameter_RULES}" "${parameter_WORKFLOW}" "${parameter_RELEVANT_CHANGES}" ${targets})
+  ConfigureFeedbackTargetFromTargets ("${name}" "${parameter_RULES}" "${parameter_WORKFLOW}" "${parameter_RELEVANT_CHANGES}" "${parameter_BASELINE}" ${targets})
 endfunction ()
 
 function (Feedback_SetDefaults)
-  cmake_parse_arguments (parameter "" "WORKFLOW;RELEVANT_CHANGES" "" ${ARGN})
+  cmake_parse_arguments (parameter "" "WORKFLOW;RELEVANT_CHANGES;CHANGE_DETECTION" "" ${ARGN})
 
   if (DEFINED parameter_UNPARSED_ARGUMENTS)
     message (FATAL_ERROR "Unparsed arguments: ${parameter_UNPARSED_ARGUMENTS}")
@@ -148,6 +154,14 @@ function (Feedback_SetDefaults)
   if (DEFINED parameter_RELEVANT_CHANGES)
     set_property(GLOBAL PROPERTY FEEDBACK_DEFAULT_RELEVANT_CHANGES "${parameter_RELEVANT_CHANGES}")
   endif ()
+
+  if (DEFINED parameter_CHANGE_DETECTION)
+    if (NOT parameter_CHANGE_DETECTION MATCHES "^(diff|generator)$")
+      message (FATAL_ERROR "Unknown change detection: ${parameter_CHANGE_DETECTION}")
+    endif ()
+
+    set_property(GLOBAL PROPERTY FEEDBACK_DEFAULT_CHANGE_DETECTION "${parameter_CHANGE_DETECTION}")
+  endif ()
 endfunction ()
 
 #  Feedback_AddWorkflow (ci)
@@ -201,7 +201,7 @@ function (_Feedback_Repository repository_variable)
   set (${repository_variable} "${worktree}" PARENT_SCOPE)
 endfunction ()
 
-function (ConfigureFeedbackTargetFromTargets name rules workflow changes)
+function (ConfigureFeedbackTargetFromTargets name rules workflow changes baseline)
 
   _Feedback_RelevantTargets (relevant_targets "${name}" ${ARGN})
 
@@ -216,90 +216,173 @@ function (ConfigureFeedbackTargetFromTargets name rules workflow changes)
   _Feedback_Worktree (worktree)
   _Feedback_Repository (repository HINT "${worktree}")
 
-  _Feedback_RelevantSourcesFromTargets (relevant_sources ${relevant_targets})
-
-  string (MAKE_C_IDENTIFIER "${name}-diff" feedback_target_diff)
-  string (TOLOWER "${feedback_target_diff}" feedback_target_diff)
-
-  set (WORKING_DIRECTORY "${worktree}")
-  set (UNTRACKED_FILES_DIFF "${feedback_source_dir}/${feedback_target_diff}/untracked.diff")
-
-  configure_file ("${feedback_main_SOURCE_DIR}/module/diff-untracked-files.cmake" "${feedback_source_dir}/${feedback_target_diff}/diff-untracked-files.cmake" @ONLY)
-
-  add_library ("${feedback_target_diff}" STATIC EXCLUDE_FROM_ALL)
-
-  add_custom_command (
-    OUTPUT "${UNTRACKED_FILES_DIFF}"
-    COMMAND "${CMAKE_COMMAND}" "-P" "${feedback_source_dir}/${feedback_target_diff}/diff-untracked-files.cmake"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS "${repository}/.git/index" ${relevant_sources}
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/all.diff"
-    COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/all.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "@{push}" >> "${feedback_source_dir}/${feedback_target_diff}/all.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/FETCH_HEAD" "${UNTRACKED_FILES_DIFF}"
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
-    COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" >> "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/index" "${UNTRACKED_FILES_DIFF}"
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
-    COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "@" >> "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${UNTRACKED_FILES_DIFF}"
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/staged.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "--staged" "@" > "${feedback_source_dir}/${feedback_target_diff}/staged.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${repository}/.git/index"
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/staged_or_committed.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "--staged" "@{push}" > "${feedback_source_dir}/${feedback_target_diff}/staged_or_committed.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/FETCH_HEAD" "${repository}/.git/index"
-    )
-
-  add_custom_command (
-    OUTPUT "${feedback_source_dir}/${feedback_target_diff}/committed.diff"
-    COMMAND "$<TARGET_FILE:Git::Git>" "log" "--unified=0" "--branches" "--not" "--remotes" "--format=format:" > "${feedback_source_dir}/${feedback_target_diff}/committed.diff"
-    WORKING_DIRECTORY "${WORKING_DIRECTORY}"
-    DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${repository}/.git/FETCH_HEAD"
-    )
-
-  target_sources ("${feedback_target_diff}" PRIVATE "${UNTRACKED_FILES_DIFF}")
-  target_sources ("${feedback_target_diff}" PRIVATE "${feedback_source_dir}/${feedback_target_diff}/${changes}.diff")
-  set_target_properties ("${feedback_target_diff}" PROPERTIES LINKER_LANGUAGE "CXX" FOLDER "feedback" EXCLUDED_FROM_FEEDBACK "(^.*$)")
+  if (FEEDBACK_USE_COMPILE_COMMANDS)
+    if (NOT CMAKE_EXPORT_COMPILE_COMMANDS)
+      message (FATAL_ERROR "FEEDBACK_USE_COMPILE_COMMANDS requires CMAKE_EXPORT_COMPILE_COMMANDS.")
+    endif ()
+
+    if (CMAKE_VERSION VERSION_LESS 3.20 AND NOT CMAKE_GENERATOR MATCHES "Ninja")
+      message (FATAL_ERROR "FEEDBACK_USE_COMPILE_COMMANDS requires CMake 3.20 or Ninja.")
+    endif ()
+
+    # the generator reads the sources at build time, walking the target properties takes long in large projects
+    set (compile_commands "${CMAKE_BINARY_DIR}/compile_commands.json")
+    set (sources_parameter "--compile-commands=${compile_commands}" "--headers-from-depfiles")
+    unset (relevant_sources)
+  else ()
+    _Feedback_RelevantSourcesFromTargets (relevant_sources ${relevant_targets})
+  endif ()
+
+  get_property (change_detection GLOBAL PROPERTY FEEDBACK_DEFAULT_CHANGE_DETECTION)
+
+  if (baseline)
+    # the generator reports only findings missing in the baseline, which needs no diff at all
+    set (changes_parameter "--baseline=${baseline}")
+    unset (feedback_target_diff)
+  elseif (change_detection STREQUAL "generator")
+    # the generator runs git itself, restricted to the sources of each target
+    set (changes_parameter "--changes=${changes}")
+    unset (feedback_target_diff)
+  else ()
+    string (MAKE_C_IDENTIFIER "${name}-diff" feedback_target_diff)
+    string (TOLOWER "${feedback_target_diff}" feedback_target_diff)
+
+    set (WORKING_DIRECTORY "${worktree}")
+    set (UNTRACKED_FILES_DIFF "${feedback_source_dir}/${feedback_target_diff}/untracked.diff")
+
+    configure_file ("${feedback_main_SOURCE_DIR}/module/diff-untracked-files.cmake" "${feedback_source_dir}/${feedback_target_diff}/diff-untracked-files.cmake" @ONLY)
+
+    add_library ("${feedback_target_diff}" STATIC EXCLUDE_FROM_ALL)
+
+    if (FEEDBACK_USE_COMPILE_COMMANDS)
+      # the sources are unknown at configure time, the script writes the untracked files it diffed as dependencies
+      add_custom_command (
+        OUTPUT "${UNTRACKED_FILES_DIFF}"
+        COMMAND "${CMAKE_COMMAND}" "-P" "${feedback_source_dir}/${feedback_target_diff}/diff-untracked-files.cmake"
+        WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+        DEPENDS "${repository}/.git/index" "${compile_commands}"
+        DEPFILE "${UNTRACKED_FILES_DIFF}.d"
+        )
+    else ()
+      add_custom_command (
+        OUTPUT "${UNTRACKED_FILES_DIFF}"
+        COMMAND "${CMAKE_COMMAND}" "-P" "${feedback_source_dir}/${feedback_target_diff}/diff-untracked-files.cmake"
+        WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+        DEPENDS "${repository}/.git/index" ${relevant_sources}
+        )
+    endif ()
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/all.diff"
+      COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/all.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "@{push}" >> "${feedback_source_dir}/${feedback_target_diff}/all.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/FETCH_HEAD" "${UNTRACKED_FILES_DIFF}"
+      )
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
+      COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" >> "${feedback_source_dir}/${feedback_target_diff}/modified.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/index" "${UNTRACKED_FILES_DIFF}"
+      )
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
+      COMMAND "${CMAKE_COMMAND}" "-E" "copy" "${UNTRACKED_FILES_DIFF}" "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "@" >> "${feedback_source_dir}/${feedback_target_diff}/modified_or_staged.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${UNTRACKED_FILES_DIFF}"
+      )
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/staged.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "--staged" "@" > "${feedback_source_dir}/${feedback_target_diff}/staged.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${repository}/.git/index"
+      )
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/staged_or_committed.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "diff" "--unified=0" "--staged" "@{push}" > "${feedback_source_dir}/${feedback_target_diff}/staged_or_committed.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/FETCH_HEAD" "${repository}/.git/index"
+      )
+
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/committed.diff"
+      COMMAND "$<TARGET_FILE:Git::Git>" "log" "--unified=0" "--branches" "--not" "--remotes" "--format=format:" > "${feedback_source_dir}/${feedback_target_diff}/committed.diff"
+      WORKING_DIRECTORY "${WORKING_DIRECTORY}"
+      DEPENDS Git::Git "${repository}/.git/logs/HEAD" "${repository}/.git/HEAD" "${repository}/.git/FETCH_HEAD"
+      )
+
+    # parse the diff once for all targets of this feedback
+    add_custom_command (
+      OUTPUT "${feedback_source_dir}/${feedback_target_diff}/${changes}.diff.index"
+      COMMAND "$<TARGET_FILE:feedback-generator>" "--index-only" "--diff=${feedback_source_dir}/${feedback_target_diff}/${changes}.diff" "--diff-index=${feedback_source_dir}/${feedback_target_diff}/${changes}.diff.index"
+      DEPENDS feedback-generator "${feedback_source_dir}/${feedback_target_diff}/${changes}.diff"
+      )
+
+    target_sources ("${feedback_target_diff}" PRIVATE "${UNTRACKED_FILES_DIFF}")
+    target_sources ("${feedback_target_diff}" PRIVATE "${feedback_source_dir}/${feedback_target_diff}/${changes}.diff")
+    target_sources ("${feedback_target_diff}" PRIVATE "${feedback_source_dir}/${feedback_target_diff}/${changes}.diff.index")
+    set_target_properties ("${feedback_target_diff}" PROPERTIES LINKER_LANGUAGE "CXX" FOLDER "feedback" EXCLUDED_FROM_FEEDBACK "(^.*$)")
+
+    set (changes_parameter "--diff=${feedback_source_dir}/${feedback_target_diff}/${changes}.diff" "--diff-index=${feedback_source_dir}/${feedback_target_diff}/${changes}.diff.index")
+  endif ()
 
   string (MAKE_C_IDENTIFIER "${name}" feedback_target_library)
   string (TOLOWER "${feedback_target_library}" feedback_target_library)
 
   add_library ("${feedback_target_library}" STATIC EXCLUDE_FROM_ALL)
-  add_dependencies ("${feedback_target_library}" "${feedback_target_diff}")
+
+  if (feedback_target_diff)
+    add_dependencies ("${feedback_target_library}" "${feedback_target_diff}")
+  endif ()
 
   target_sources ("${feedback_target_library}" PRIVATE "${rules}" "${workflow}")
 
+  if (baseline)
+    # records the current findings of all targets on demand
+    if (NOT FEEDBACK_USE_COMPILE_COMMANDS)
+      _Feedback_WriteFileList ("${feedback_source_dir}/${feedback_target_library}/baseline.sources.txt" ${relevant_sources})
+      set (sources_parameter "${feedback_source_dir}/${feedback_target_library}/baseline.sources.txt")
+    endif ()
+
+    add_custom_target ("${feedback_target_library}-baseline"
+      COMMAND "$<TARGET_FILE:feedback-generator>" "--workflow=${workflow}" "--write-baseline=${baseline}" "${rules}" ${sources_parameter} ">" "${feedback_source_dir}/${feedback_target_library}/baseline.cpp"
+      WORKING_DIRECTORY "${worktree}"
+      DEPENDS feedback-generator
+      COMMENT "Recording the findings of ${name} as baseline"
+      )
+    set_target_properties ("${feedback_target_library}-baseline" PROPERTIES FOLDER "feedback" EXCLUDED_FROM_FEEDBACK "(^.*$)")
+  endif ()
+
   foreach (target IN LISTS relevant_targets)
+    if (FEEDBACK_USE_COMPILE_COMMANDS)
+      # the generator writes the sources it scanned as dependencies of its output
+      add_custom_command (
+        OUTPUT "${feedback_source_dir}/${feedback_target_library}/${target}.cpp"
+        COMMAND "$<TARGET_FILE:feedback-generator>" "--workflow=${workflow}" ${changes_parameter} ${sources_parameter} "--compile-commands-target=${target}" "--output=${feedback_source_dir}/${feedback_target_library}/${target}.cpp" "--write-depfile=${feedback_source_dir}/${feedback_target_library}/${target}.cpp.d" "${rules}"
+        WORKING_DIRECTORY "${worktree}"
+        DEPENDS feedback-generator "${rules}" "${workflow}" ${baseline} "${compile_commands}"
+        DEPFILE "${feedback_source_dir}/${feedback_target_library}/${target}.cpp.d"
+        )
+      target_sources ("${feedback_target_library}" PRIVATE "${feedback_source_dir}/${feedback_target_library}/${target}.cpp")
+
+      add_dependencies ("${target}" "${feedback_target_library}")
+      continue ()
+    endif ()
+
     _Feedback_RelevantSourcesFromTargets (relevant_sources "${target}")
     _Feedback_WriteFileList ("${feedback_source_dir}/${feedback_target_library}/${target}.sources.txt" ${relevant_sources})
 
     add_custom_command (
       OUTPUT "${feedback_source_dir}/${feedback_target_library}/${target}.cpp"
-      COMMAND "$<TARGET_FILE:feedback-generator>" "--workflow=${workflow}" "--diff=${feedback_source_dir}/${feedback_target_diff}/${changes}.diff" "${rules}" "${feedback_source_dir}/${feedback_target_library}/${target}.sources.txt" ">" "${feedback_source_dir}/${feedback_target_library}/${target}.cpp"
-      DEPENDS feedback-generator "${rules}" "${workflow}" "${feedback_source_dir}/${feedback_target_library}/${target}.sources.txt" ${relevant_sources} # sic! no dependency to diff. really?
+      COMMAND "$<TARGET_FILE:feedback-generator>" "--workflow=${workflow}" ${changes_parameter} "${rules}" "${feedback_source_dir}/${feedback_target_library}/${target}.sources.txt" ">" "${feedback_source_dir}/${feedback_target_library}/${target}.cpp"
+      WORKING_DIRECTORY "${worktree}"
+      DEPENDS feedback-generator "${rules}" "${workflow}" ${baseline} "${feedback_source_dir}/${feedback_target_library}/${target}.sources.txt" ${relevant_sources} # sic! no dependency to diff. really?
       )
     target_sources ("${feedback_target_library}" PRIVATE "${feedback_source_dir}/${feedback_target_library}/${target}.cpp")
 
@@ -328,8 +411,13 @@ function (_Feedback_Configure)
                    BRIEF_DOCS "default relevant changes for feedback"
                    FULL_DOCS "default relevant changes for feedback")
 
+  define_property (GLOBAL PROPERTY FEEDBACK_DEFAULT_CHANGE_DETECTION
+                   BRIEF_DOCS "default change detection for feedback (diff or generator)"
+                   FULL_DOCS "default change detection for feedback: 'diff' writes diff files with custom commands, 'generator' lets the generator run git itself")
+
 set_property(GLOBAL PROPERTY FEEDBACK_DEFAULT_WORKFLOW "${feedback_main_SOURCE_DIR}/module/default_workflow.json")
 set_property(GLOBAL PROPERTY FEEDBACK_DEFAULT_RELEVANT_CHANGES "modified_or_staged")
+set_property(GLOBAL PROPERTY FEEDBACK_DEFAULT_CHANGE_DETECTION "diff")
 
   # adding the generator as an external project is preferable because we
   #  * build the generator always in release configuration
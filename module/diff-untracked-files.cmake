@@ -13,7 +13,22 @@ endif ()
 
 file (TOUCH "@UNTRACKED_FILES_DIFF@")
 
+# the diffed files as dependencies of the diff, for build systems which know no sources at configure time
+function (_escape_for_depfile variable file)
+  string (REPLACE "$" "$$" file "${file}")
+  string (REGEX REPLACE "([ #])" "\\\\\\1" file "${file}")
+  set (${variable} "${file}" PARENT_SCOPE)
+endfunction ()
+
+_escape_for_depfile (depfile "@UNTRACKED_FILES_DIFF@")
+string (APPEND depfile ":")
+
 foreach (source IN LISTS sources)
   execute_process (COMMAND "@GIT_EXECUTABLE@" "diff" "--unified=0" "--no-index" "/dev/null" "${source}" WORKING_DIRECTORY "@WORKING_DIRECTORY@" OUTPUT_VARIABLE output)
   file (APPEND "@UNTRACKED_FILES_DIFF@" "${output}")
+
+  _escape_for_depfile (prerequisite "@WORKING_DIRECTORY@/${source}")
+  string (APPEND depfile " \\\n  ${prerequisite}")
 endforeach ()
+
+file (WRITE "@UNTRACKED_FILES_DIFF@.d" "${depfile}\n")